@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "basic_version.hpp"
+#include <stdexcept>
+#include "../gettext_defs.h"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  uint64_t parse_version_component(std::string_view s, uint64_t max)
+  {
+    if (s.empty() || (s.size() > 1 && s[0] == '0'))
+      throw std::invalid_argument(
+        _("Invalid version component: ") + std::string(s));
+
+    uint64_t value = 0;
+
+    for (char c : s)
+    {
+      if (c < '0' || c > '9')
+        throw std::invalid_argument(
+          _("Invalid version component: ") + std::string(s));
+
+      uint64_t digit = static_cast<uint64_t>(c - '0');
+
+      if (value > (max - digit) / 10)
+        throw std::out_of_range(
+          _("Version component too large: ") + std::string(s));
+
+      value = value * 10 + digit;
+    }
+
+    return value;
+  }
+
+  void check_version_arity(const version& v, size_t arity)
+  {
+    if (v.get_version_count() != arity)
+      throw std::invalid_argument(
+        _("Invalid number of version components: ") + v.str());
+
+    if (!v.is_release())
+      throw std::invalid_argument(
+        _("Prerelease versions are not supported: ") + v.str());
+  }
+}
+
+#pragma clang diagnostic pop
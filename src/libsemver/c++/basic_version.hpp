@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the semver::basic_version class template.
+ *
+ * This header defines the semver::basic_version class template, a release
+ * version with a fixed number of integer components.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_BASIC_VERSION_H
+#define SEMVER_UTILS_BASIC_VERSION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "version.hpp"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief Parses a version component which must not exceed @p max.
+   *
+   * @throws std::out_of_range if the component is greater than @p max.
+   * @throws std::invalid_argument if @p s is not a number without leading
+   * zeroes.
+   */
+  uint64_t parse_version_component(std::string_view s, uint64_t max);
+
+  /**
+   * @brief Checks that @p v is a release version with @p arity components.
+   *
+   * @throws std::invalid_argument if it is not.
+   */
+  void check_version_arity(const version& v, size_t arity);
+
+  /**
+   * @brief Class template that represents a release version with @p N
+   * components of unsigned integer type @p IntT.
+   *
+   * semver::version accepts any number of components of any size, and stores
+   * them as strings.  When the versions of a workload are known to be releases
+   * such as `MAJOR.MINOR.PATCH` with small components, a basic_version is a
+   * much cheaper alternative: it is trivially copyable, it is compared
+   * without branching on each component, and it can be stored in contiguous
+   * arrays.
+   *
+   * Prerelease versions cannot be represented, and metadata is not stored.
+   * Instances are converted from and to semver::version by from_version()
+   * and to_version().
+   */
+  template<size_t N = 3, typename IntT = uint32_t>
+  class basic_version
+  {
+    static_assert(N >= 3, "A version has at least three components.");
+    static_assert(std::is_unsigned<IntT>::value
+                  && sizeof(IntT) <= sizeof(uint64_t),
+                  "Components must be unsigned integers of at most 64 bits.");
+
+  public:
+    /**
+     * @brief Type of the components.
+     */
+    using value_type = IntT;
+
+    /**
+     * @brief Constructs the version `0.0.0`.
+     */
+    constexpr basic_version() = default;
+
+    /**
+     * @brief Constructs a version from its components.
+     *
+     * @param components The components of the version.
+     */
+    constexpr explicit basic_version(const std::array<IntT, N>& components) :
+      components(components)
+    {
+    }
+
+    /**
+     * @brief Converts @p v.
+     *
+     * The metadata of @p v is discarded.
+     *
+     * @param v The version to convert.
+     * @throws std::invalid_argument if @p v does not have @p N components or
+     * if it is a prerelease version.
+     * @throws std::out_of_range if a component of @p v does not fit in
+     * @p IntT.
+     */
+    static basic_version from_version(const version& v)
+    {
+      check_version_arity(v, N);
+
+      basic_version result;
+
+      for (size_t i = 0; i < N; ++i)
+        result.components[i] = static_cast<IntT>(
+          parse_version_component(v.get_version_view(i),
+                                  std::numeric_limits<IntT>::max()));
+
+      return result;
+    }
+
+    /**
+     * @brief Converts this instance to a semver::version.
+     */
+    version to_version() const
+    {
+      std::vector<std::string> numbers(N);
+
+      for (size_t i = 0; i < N; ++i) numbers[i] = std::to_string(components[i]);
+
+      return version(std::move(numbers), "", "");
+    }
+
+    /**
+     * @brief Gets the component @p index.
+     */
+    constexpr IntT operator[](size_t index) const
+    {
+      return components[index];
+    }
+
+    /**
+     * @brief Compares two versions.
+     *
+     * @return A negative number, zero or a positive number if @p lh has lower,
+     * equal or higher precedence than @p rh, respectively.
+     */
+    static constexpr int compare(const basic_version& lh,
+                                 const basic_version& rh)
+    {
+      // The first differing component decides: the selection compiles to
+      // conditional moves rather than to a branch per component.
+      int result = 0;
+
+      for (size_t i = 0; i < N; ++i)
+      {
+        int c = (lh.components[i] > rh.components[i])
+                - (lh.components[i] < rh.components[i]);
+        result = (result != 0) ? result : c;
+      }
+
+      return result;
+    }
+
+    constexpr bool operator==(const basic_version& rh) const
+    {
+      return compare(*this, rh) == 0;
+    }
+
+    constexpr bool operator!=(const basic_version& rh) const
+    {
+      return compare(*this, rh) != 0;
+    }
+
+    constexpr bool operator<(const basic_version& rh) const
+    {
+      return compare(*this, rh) < 0;
+    }
+
+    constexpr bool operator<=(const basic_version& rh) const
+    {
+      return compare(*this, rh) <= 0;
+    }
+
+    constexpr bool operator>(const basic_version& rh) const
+    {
+      return compare(*this, rh) > 0;
+    }
+
+    constexpr bool operator>=(const basic_version& rh) const
+    {
+      return compare(*this, rh) >= 0;
+    }
+
+  private:
+    std::array<IntT, N> components{};
+  };
+
+  /**
+   * @brief A `MAJOR.MINOR.PATCH` release version with 32-bit components.
+   */
+  using version3 = basic_version<3, uint32_t>;
+}
+
+#endif // SEMVER_UTILS_BASIC_VERSION_H
+
+#pragma clang diagnostic pop
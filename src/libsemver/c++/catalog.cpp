@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "catalog.hpp"
+#include <string>
+#include <utility>
+#include <vector>
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  bool catalog::order::operator()(const version& lh, const version& rh) const
+  {
+    if (lh < rh) return true;
+    if (rh < lh) return false;
+
+    return lh.get_metadata_view() < rh.get_metadata_view();
+  }
+
+  bool catalog::order::operator()(const version& lh,
+                                  const precedence_key& rh) const
+  {
+    return lh < rh.v;
+  }
+
+  bool catalog::order::operator()(const precedence_key& lh,
+                                  const version& rh) const
+  {
+    return lh.v < rh;
+  }
+
+  bool catalog::pointer_order::operator()(const version *lh,
+                                          const version *rh) const
+  {
+    return order()(*lh, *rh);
+  }
+
+  bool catalog::pointer_order::operator()(const version *lh,
+                                          const precedence_key& rh) const
+  {
+    return *lh < rh.v;
+  }
+
+  bool catalog::pointer_order::operator()(const precedence_key& lh,
+                                          const version *rh) const
+  {
+    return lh.v < *rh;
+  }
+
+  catalog::catalog(const catalog& other) :
+    versions(other.versions)
+  {
+    // The versions are visited in order: each release is inserted at the end
+    // of the index in constant time.
+    for (const version& v : versions)
+      if (v.is_release()) releases.insert(releases.end(), &v);
+  }
+
+  catalog& catalog::operator=(const catalog& other)
+  {
+    if (this != &other)
+    {
+      catalog copy(other);
+      *this = std::move(copy);
+    }
+
+    return *this;
+  }
+
+  bool catalog::insert(version v)
+  {
+    auto inserted = versions.insert(std::move(v));
+
+    if (inserted.second && inserted.first->is_release())
+      releases.insert(&*inserted.first);
+
+    return inserted.second;
+  }
+
+  bool catalog::erase(const version& v)
+  {
+    auto it = versions.find(v);
+
+    if (it == versions.end()) return false;
+
+    if (it->is_release()) releases.erase(&*it);
+    versions.erase(it);
+
+    return true;
+  }
+
+  bool catalog::contains(const version& v) const
+  {
+    return versions.find(v) != versions.end();
+  }
+
+  size_t catalog::size() const
+  {
+    return versions.size();
+  }
+
+  bool catalog::empty() const
+  {
+    return versions.empty();
+  }
+
+  void catalog::clear()
+  {
+    releases.clear();
+    versions.clear();
+  }
+
+  catalog::const_iterator catalog::lower_bound(const version& v) const
+  {
+    return versions.lower_bound(precedence_key{v});
+  }
+
+  catalog::const_iterator catalog::upper_bound(const version& v) const
+  {
+    return versions.upper_bound(precedence_key{v});
+  }
+
+  std::optional<version> catalog::predecessor(const version& v) const
+  {
+    auto it = lower_bound(v);
+
+    if (it == versions.begin()) return std::nullopt;
+
+    return *--it;
+  }
+
+  std::optional<version> catalog::successor(const version& v) const
+  {
+    auto it = upper_bound(v);
+
+    if (it == versions.end()) return std::nullopt;
+
+    return *it;
+  }
+
+  std::optional<version> catalog::latest_release(unsigned long major) const
+  {
+    // The least versions of the major line and of the next one: versions
+    // with fewer components precede the ones they are a prefix of, and -0 is
+    // the lowest prerelease identifier.  The versions are compared only by
+    // precedence, whatever the number and the spelling of their components.
+    const version first(std::vector<std::string>{std::to_string(major), "0"},
+                        "0",
+                        "");
+    auto it = releases.lower_bound(precedence_key{first.bump_major()});
+
+    if (it == releases.begin() || **--it < first) return std::nullopt;
+
+    return **it;
+  }
+
+  catalog::const_iterator catalog::begin() const
+  {
+    return versions.begin();
+  }
+
+  catalog::const_iterator catalog::end() const
+  {
+    return versions.end();
+  }
+
+  catalog::const_reverse_iterator catalog::rbegin() const
+  {
+    return versions.rbegin();
+  }
+
+  catalog::const_reverse_iterator catalog::rend() const
+  {
+    return versions.rend();
+  }
+}
+
+#pragma clang diagnostic pop
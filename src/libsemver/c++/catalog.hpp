@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the semver::catalog class.
+ *
+ * This header defines the semver::catalog class, an ordered set of versions
+ * that is maintained incrementally as versions are published or withdrawn.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_CATALOG_H
+#define SEMVER_UTILS_CATALOG_H
+
+#include <cstddef>
+#include <optional>
+#include <set>
+#include "version.hpp"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief Ordered set of versions.
+   *
+   * Versions are kept sorted by precedence in a balanced search tree, so that
+   * insertions, removals and ordered queries take logarithmic time without
+   * sorting the whole set again.  Versions with the same precedence but
+   * different metadata, such as `1.0.0+a` and `1.0.0+b`, are distinct elements
+   * ordered by their metadata.
+   */
+  class catalog
+  {
+    // Orders versions by precedence, then by metadata.  Comparisons with a
+    // precedence_key only take precedence into account, which lets lookups
+    // find all the versions with a given precedence.
+    struct precedence_key
+    {
+      const version& v;
+    };
+
+    struct order
+    {
+      using is_transparent = void;
+
+      bool operator()(const version& lh, const version& rh) const;
+      bool operator()(const version& lh, const precedence_key& rh) const;
+      bool operator()(const precedence_key& lh, const version& rh) const;
+    };
+
+    // Orders pointers to versions as the versions they point to.
+    struct pointer_order
+    {
+      using is_transparent = void;
+
+      bool operator()(const version *lh, const version *rh) const;
+      bool operator()(const version *lh, const precedence_key& rh) const;
+      bool operator()(const precedence_key& lh, const version *rh) const;
+    };
+
+    std::set<version, order> versions;
+
+    // The release versions of the catalog, pointing to the elements of
+    // versions, so that latest_release() does not skip prereleases.
+    std::set<const version *, pointer_order> releases;
+
+  public:
+    /**
+     * @brief Iterator over the versions of the catalog, in ascending order.
+     */
+    using const_iterator = std::set<version, order>::const_iterator;
+
+    /**
+     * @brief Iterator over the versions of the catalog, in descending order.
+     */
+    using const_reverse_iterator =
+      std::set<version, order>::const_reverse_iterator;
+
+    /**
+     * @brief Constructs an empty catalog.
+     */
+    catalog() = default;
+
+    catalog(const catalog& other);
+    catalog(catalog&&) = default;
+    catalog& operator=(const catalog& other);
+    catalog& operator=(catalog&&) = default;
+
+    /**
+     * @brief Inserts @p v into the catalog.
+     *
+     * @param v The version to insert.
+     * @return `true` if @p v was inserted, `false` if it was already contained
+     * in the catalog.
+     */
+    bool insert(version v);
+
+    /**
+     * @brief Removes @p v from the catalog.
+     *
+     * @param v The version to remove, metadata included.
+     * @return `true` if @p v was removed, `false` if it was not contained in
+     * the catalog.
+     */
+    bool erase(const version& v);
+
+    /**
+     * @brief Checks whether @p v, metadata included, is contained in the
+     * catalog.
+     */
+    bool contains(const version& v) const;
+
+    /**
+     * @brief Gets the number of versions in the catalog.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether the catalog is empty.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Removes all the versions from the catalog.
+     */
+    void clear();
+
+    /**
+     * @brief Gets an iterator to the least version whose precedence is not
+     * lower than the precedence of @p v.
+     */
+    const_iterator lower_bound(const version& v) const;
+
+    /**
+     * @brief Gets an iterator to the least version whose precedence is higher
+     * than the precedence of @p v.
+     */
+    const_iterator upper_bound(const version& v) const;
+
+    /**
+     * @brief Gets the greatest version whose precedence is lower than the
+     * precedence of @p v.
+     *
+     * @param v The version to compare to, which need not be contained in the
+     * catalog.
+     * @return The predecessor of @p v, if any.
+     */
+    std::optional<version> predecessor(const version& v) const;
+
+    /**
+     * @brief Gets the least version whose precedence is higher than the
+     * precedence of @p v.
+     *
+     * @param v The version to compare to, which need not be contained in the
+     * catalog.
+     * @return The successor of @p v, if any.
+     */
+    std::optional<version> successor(const version& v) const;
+
+    /**
+     * @brief Gets the greatest release version whose major component is
+     * @p major.
+     *
+     * The release versions are indexed separately from the prereleases, so
+     * that the search takes logarithmic time.
+     *
+     * @param major The major component.
+     * @return The latest release in the major line, if any.
+     */
+    std::optional<version> latest_release(unsigned long major) const;
+
+    /**
+     * @brief Gets an iterator to the least version of the catalog.
+     */
+    const_iterator begin() const;
+
+    /**
+     * @brief Gets the past-the-end iterator of the catalog.
+     */
+    const_iterator end() const;
+
+    /**
+     * @brief Gets a reverse iterator to the greatest version of the catalog.
+     */
+    const_reverse_iterator rbegin() const;
+
+    /**
+     * @brief Gets the past-the-end reverse iterator of the catalog.
+     */
+    const_reverse_iterator rend() const;
+  };
+}
+
+#endif // SEMVER_UTILS_CATALOG_H
+
+#pragma clang diagnostic pop
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "columnar_set.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include "basic_version.hpp"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  static unsigned int bit_width(uint64_t v)
+  {
+    unsigned int width = 0;
+
+    while (v != 0)
+    {
+      ++width;
+      v >>= 1;
+    }
+
+    return width;
+  }
+
+  packed_column::packed_column(const std::vector<uint64_t>& values) :
+    count(values.size())
+  {
+    for (size_t first = 0; first < values.size(); first += BLOCK_SIZE)
+    {
+      size_t last = std::min(first + BLOCK_SIZE, values.size());
+      auto range = std::minmax_element(values.begin() + first,
+                                       values.begin() + last);
+      uint64_t base = *range.first;
+      unsigned int width = bit_width(*range.second - base);
+
+      blocks.push_back({base, bits.size() * 64, width});
+
+      if (width == 0) continue;
+
+      size_t bit = bits.size() * 64;
+      bits.resize(bits.size() + ((last - first) * width + 63) / 64, 0);
+
+      for (size_t i = first; i < last; ++i, bit += width)
+      {
+        uint64_t delta = values[i] - base;
+        size_t word = bit / 64;
+        unsigned int shift = bit % 64;
+
+        bits[word] |= delta << shift;
+        if (shift + width > 64) bits[word + 1] |= delta >> (64 - shift);
+      }
+    }
+  }
+
+  uint64_t packed_column::operator[](size_t i) const
+  {
+    const block& b = blocks[i / BLOCK_SIZE];
+
+    if (b.width == 0) return b.base;
+
+    size_t bit = b.offset + (i % BLOCK_SIZE) * b.width;
+    size_t word = bit / 64;
+    unsigned int shift = bit % 64;
+    uint64_t delta = bits[word] >> shift;
+
+    if (shift + b.width > 64) delta |= bits[word + 1] << (64 - shift);
+    if (b.width < 64) delta &= (uint64_t(1) << b.width) - 1;
+
+    return b.base + delta;
+  }
+
+  size_t packed_column::size() const
+  {
+    return count;
+  }
+
+  size_t packed_column::memory_usage() const
+  {
+    return sizeof(*this)
+           + blocks.capacity() * sizeof(block)
+           + bits.capacity() * sizeof(uint64_t);
+  }
+
+  uint32_t columnar_set::builder::intern(
+    std::vector<std::string>& dictionary,
+    std::unordered_map<std::string, uint32_t>& index,
+    const std::string& s)
+  {
+    auto it = index.find(s);
+    if (it != index.end()) return it->second;
+
+    uint32_t code = static_cast<uint32_t>(dictionary.size());
+    dictionary.push_back(s);
+    index.emplace(s, code);
+
+    return code;
+  }
+
+  void columnar_set::builder::add(const version& v)
+  {
+    std::vector<uint64_t> values(v.get_version_count());
+
+    // Components are parsed before any column is modified, so that a failure
+    // leaves the builder unchanged.
+    for (size_t i = 0; i < values.size(); ++i)
+      values[i] = parse_version_component(v.get_version_view(i),
+                                          std::numeric_limits<uint64_t>::max());
+
+    size_t rows = arities.size();
+
+    if (components.size() < values.size())
+      components.resize(values.size(), std::vector<uint64_t>(rows, 0));
+
+    for (size_t i = 0; i < components.size(); ++i)
+      components[i].push_back(i < values.size() ? values[i] : 0);
+
+    arities.push_back(values.size());
+    prerelease_codes.push_back(
+      intern(prereleases, prerelease_index, v.get_prerelease()));
+    metadata_codes.push_back(
+      intern(metadata, metadata_index, v.get_metadata()));
+  }
+
+  // Sorts the strings of a dictionary and returns the rank of each code.
+  template<typename Compare>
+  static std::vector<uint32_t> rank(const std::vector<std::string>& dictionary,
+                                    std::vector<uint32_t>& order,
+                                    Compare compare)
+  {
+    order.resize(dictionary.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), compare);
+
+    std::vector<uint32_t> ranks(dictionary.size());
+    for (size_t i = 0; i < order.size(); ++i) ranks[order[i]] = i;
+
+    return ranks;
+  }
+
+  // Concatenates the strings of a dictionary in the specified order.
+  static void fill(const std::vector<std::string>& strings,
+                   const std::vector<uint32_t>& order,
+                   std::string& data,
+                   std::vector<size_t>& offsets)
+  {
+    for (uint32_t code : order)
+    {
+      data += strings[code];
+      offsets.push_back(data.size());
+    }
+  }
+
+  columnar_set columnar_set::builder::build()
+  {
+    columnar_set set;
+
+    // Prerelease codes are ranked by precedence, releases last, so that rows
+    // can be compared by code; metadata codes are ranked alphabetically.
+    std::vector<version> parsed;
+    parsed.reserve(prereleases.size());
+
+    for (const auto& p : prereleases)
+      parsed.emplace_back(std::vector<std::string>{"0", "0", "0"}, p, "");
+
+    std::vector<uint32_t> prerelease_order;
+    std::vector<uint32_t> prerelease_rank =
+      rank(prereleases,
+           prerelease_order,
+           [&parsed](uint32_t lh, uint32_t rh)
+           {
+             return parsed[lh] < parsed[rh];
+           });
+
+    std::vector<uint32_t> metadata_order;
+    std::vector<uint32_t> metadata_rank =
+      rank(metadata,
+           metadata_order,
+           [this](uint32_t lh, uint32_t rh)
+           {
+             return metadata[lh] < metadata[rh];
+           });
+
+    auto compare = [&](size_t lh, size_t rh)
+    {
+      size_t common = std::min(arities[lh], arities[rh]);
+
+      for (size_t i = 0; i < common; ++i)
+      {
+        if (components[i][lh] != components[i][rh])
+          return components[i][lh] < components[i][rh];
+      }
+
+      if (arities[lh] != arities[rh]) return arities[lh] < arities[rh];
+
+      uint32_t lp = prerelease_rank[prerelease_codes[lh]];
+      uint32_t rp = prerelease_rank[prerelease_codes[rh]];
+      if (lp != rp) return lp < rp;
+
+      return metadata_rank[metadata_codes[lh]] < metadata_rank[metadata_codes[rh]];
+    };
+
+    std::vector<size_t> rows(arities.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    std::sort(rows.begin(), rows.end(), compare);
+    rows.erase(std::unique(rows.begin(),
+                           rows.end(),
+                           [&compare](size_t lh, size_t rh)
+                           {
+                             return !compare(lh, rh) && !compare(rh, lh);
+                           }),
+               rows.end());
+
+    // Lay out the columns in sorted order and compress them.
+    std::vector<uint64_t> column(rows.size());
+
+    for (const auto& values : components)
+    {
+      for (size_t i = 0; i < rows.size(); ++i) column[i] = values[rows[i]];
+      set.components.emplace_back(column);
+    }
+
+    for (size_t i = 0; i < rows.size(); ++i) column[i] = arities[rows[i]];
+    set.arities = packed_column(column);
+
+    for (size_t i = 0; i < rows.size(); ++i)
+      column[i] = prerelease_rank[prerelease_codes[rows[i]]];
+    set.prerelease_codes = packed_column(column);
+
+    for (size_t i = 0; i < rows.size(); ++i)
+      column[i] = metadata_rank[metadata_codes[rows[i]]];
+    set.metadata_codes = packed_column(column);
+
+    fill(prereleases, prerelease_order,
+         set.prereleases.data, set.prereleases.offsets);
+    fill(metadata, metadata_order,
+         set.metadata_strings.data, set.metadata_strings.offsets);
+
+    set.count = rows.size();
+
+    *this = builder();
+
+    return set;
+  }
+
+  std::string_view columnar_set::dictionary::operator[](size_t code) const
+  {
+    return std::string_view(data).substr(offsets[code],
+                                         offsets[code + 1] - offsets[code]);
+  }
+
+  size_t columnar_set::dictionary::memory_usage() const
+  {
+    return data.capacity() + offsets.capacity() * sizeof(size_t);
+  }
+
+  size_t columnar_set::size() const
+  {
+    return count;
+  }
+
+  bool columnar_set::empty() const
+  {
+    return count == 0;
+  }
+
+  size_t columnar_set::arity(size_t i) const
+  {
+    return static_cast<size_t>(arities[i]);
+  }
+
+  uint64_t columnar_set::component(size_t i, size_t index) const
+  {
+    if (index >= arity(i)) return 0;
+
+    return components[index][i];
+  }
+
+  std::string_view columnar_set::prerelease(size_t i) const
+  {
+    return prereleases[prerelease_codes[i]];
+  }
+
+  std::string_view columnar_set::metadata(size_t i) const
+  {
+    return metadata_strings[metadata_codes[i]];
+  }
+
+  version columnar_set::operator[](size_t i) const
+  {
+    std::vector<std::string> numbers(arity(i));
+
+    for (size_t c = 0; c < numbers.size(); ++c)
+      numbers[c] = std::to_string(components[c][i]);
+
+    return version(std::move(numbers),
+                   std::string(prerelease(i)),
+                   std::string(metadata(i)));
+  }
+
+  size_t columnar_set::memory_usage() const
+  {
+    size_t usage = sizeof(*this)
+                   + arities.memory_usage()
+                   + prerelease_codes.memory_usage()
+                   + metadata_codes.memory_usage()
+                   + prereleases.memory_usage()
+                   + metadata_strings.memory_usage();
+
+    for (const auto& c : components) usage += c.memory_usage();
+
+    return usage;
+  }
+
+  columnar_set::const_iterator columnar_set::begin() const
+  {
+    return const_iterator(this, 0);
+  }
+
+  columnar_set::const_iterator columnar_set::end() const
+  {
+    return const_iterator(this, count);
+  }
+
+  columnar_set::const_iterator::const_iterator(const columnar_set *set,
+                                               size_t row) :
+    set(set), row(row)
+  {
+  }
+
+  version columnar_set::const_iterator::operator*() const
+  {
+    return (*set)[row];
+  }
+
+  columnar_set::const_iterator& columnar_set::const_iterator::operator++()
+  {
+    ++row;
+    return *this;
+  }
+
+  columnar_set::const_iterator columnar_set::const_iterator::operator++(int)
+  {
+    const_iterator previous = *this;
+    ++row;
+    return previous;
+  }
+
+  bool columnar_set::const_iterator::operator==(const const_iterator& rh) const
+  {
+    return set == rh.set && row == rh.row;
+  }
+
+  bool columnar_set::const_iterator::operator!=(const const_iterator& rh) const
+  {
+    return !(*this == rh);
+  }
+}
+
+#pragma clang diagnostic pop
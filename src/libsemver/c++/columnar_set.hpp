@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the semver::columnar_set class.
+ *
+ * This header defines the semver::columnar_set class, a compact immutable
+ * representation of large sorted sets of versions.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_COLUMNAR_SET_H
+#define SEMVER_UTILS_COLUMNAR_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "version.hpp"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief Column of unsigned integers compressed with bit packing.
+   *
+   * Values are split into blocks of semver::packed_column::BLOCK_SIZE values.
+   * Each block stores its minimum and the differences from it, packed using
+   * the number of bits required by the largest difference: runs of equal
+   * values take no space besides the block header.  Any value can be decoded
+   * in constant time.
+   */
+  class packed_column
+  {
+  public:
+    /**
+     * @brief Number of values of a block.
+     */
+    static const size_t BLOCK_SIZE = 128;
+
+    /**
+     * @brief Constructs an empty column.
+     */
+    packed_column() = default;
+
+    /**
+     * @brief Constructs a column containing @p values.
+     *
+     * @param values The values of the column.
+     */
+    explicit packed_column(const std::vector<uint64_t>& values);
+
+    /**
+     * @brief Gets the value at position @p i.
+     */
+    uint64_t operator[](size_t i) const;
+
+    /**
+     * @brief Gets the number of values of the column.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the number of bytes used by the column.
+     */
+    size_t memory_usage() const;
+
+  private:
+    struct block
+    {
+      uint64_t base;
+      size_t offset;
+      unsigned int width;
+    };
+
+    std::vector<block> blocks;
+    std::vector<uint64_t> bits;
+    size_t count = 0;
+  };
+
+  /**
+   * @brief Immutable set of versions stored by columns.
+   *
+   * Storing many semver::version objects is expensive: each one owns a vector
+   * of strings, the prerelease and metadata strings and the parsed prerelease
+   * identifiers.  A columnar_set stores the same versions sorted by precedence
+   * (and by metadata when their precedence is equal) and split into columns:
+   *
+   *   - Each numeric component is a semver::packed_column.  Since versions are
+   *     sorted, neighbouring values are close and pack in few bits.
+   *   - Prerelease and metadata strings are dictionary-encoded: each distinct
+   *     string is stored once, and rows store its code in a packed column.
+   *     Prerelease codes are assigned in order of precedence.
+   *
+   * Rows can be read in constant time without materializing a version, and
+   * versions are rebuilt on demand by operator[]() and by the iterators.
+   * Numeric components must fit in 64 bits.
+   *
+   * Sets are built by semver::columnar_set::builder.
+   */
+  class columnar_set
+  {
+  public:
+    /**
+     * @brief Class that collects the versions of a semver::columnar_set.
+     *
+     * Versions are buffered in uncompressed columns, which are sorted and
+     * compressed by build().
+     */
+    class builder
+    {
+    public:
+      /**
+       * @brief Adds @p v to the set.
+       *
+       * @param v The version to add.
+       * @throws std::out_of_range if a numeric component of @p v does not fit
+       * in 64 bits.
+       * @throws std::invalid_argument if a numeric component of @p v is not a
+       * number without leading zeroes.
+       */
+      void add(const version& v);
+
+      /**
+       * @brief Builds the set containing the added versions.  Duplicate
+       * versions are stored once.  The builder is left empty.
+       */
+      columnar_set build();
+
+    private:
+      uint32_t intern(std::vector<std::string>& dictionary,
+                      std::unordered_map<std::string, uint32_t>& index,
+                      const std::string& s);
+
+      std::vector<std::vector<uint64_t>> components;
+      std::vector<uint64_t> arities;
+      std::vector<uint32_t> prerelease_codes;
+      std::vector<uint32_t> metadata_codes;
+      std::vector<std::string> prereleases;
+      std::vector<std::string> metadata;
+      std::unordered_map<std::string, uint32_t> prerelease_index;
+      std::unordered_map<std::string, uint32_t> metadata_index;
+    };
+
+    /**
+     * @brief Iterator over the versions of a set, in ascending order.
+     *
+     * Versions are decoded as the iterator is dereferenced.
+     */
+    class const_iterator
+    {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = version;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+      using reference = version;
+
+      const_iterator(const columnar_set *set, size_t row);
+
+      version operator*() const;
+      const_iterator& operator++();
+      const_iterator operator++(int);
+      bool operator==(const const_iterator& rh) const;
+      bool operator!=(const const_iterator& rh) const;
+
+    private:
+      const columnar_set *set;
+      size_t row;
+    };
+
+    /**
+     * @brief Constructs an empty set.
+     */
+    columnar_set() = default;
+
+    /**
+     * @brief Gets the number of versions of the set.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether the set is empty.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Gets the version at position @p i of the sorted set.
+     */
+    version operator[](size_t i) const;
+
+    /**
+     * @brief Gets the number of numeric components of the version at position
+     * @p i.
+     */
+    size_t arity(size_t i) const;
+
+    /**
+     * @brief Gets the numeric component @p index of the version at position
+     * @p i, or `0` if the version has no such component.
+     */
+    uint64_t component(size_t i, size_t index) const;
+
+    /**
+     * @brief Gets the prerelease of the version at position @p i.  The view is
+     * valid as long as the set.
+     */
+    std::string_view prerelease(size_t i) const;
+
+    /**
+     * @brief Gets the metadata of the version at position @p i.  The view is
+     * valid as long as the set.
+     */
+    std::string_view metadata(size_t i) const;
+
+    /**
+     * @brief Gets the number of bytes used by the set.
+     */
+    size_t memory_usage() const;
+
+    /**
+     * @brief Gets an iterator to the least version of the set.
+     */
+    const_iterator begin() const;
+
+    /**
+     * @brief Gets the past-the-end iterator of the set.
+     */
+    const_iterator end() const;
+
+  private:
+    // Strings of a dictionary, concatenated: string i spans
+    // [offsets[i], offsets[i + 1]).
+    struct dictionary
+    {
+      std::string data;
+      std::vector<size_t> offsets{0};
+
+      std::string_view operator[](size_t code) const;
+      size_t memory_usage() const;
+    };
+
+    std::vector<packed_column> components;
+    packed_column arities;
+    packed_column prerelease_codes;
+    packed_column metadata_codes;
+    dictionary prereleases;
+    dictionary metadata_strings;
+    size_t count = 0;
+  };
+}
+
+#endif // SEMVER_UTILS_COLUMNAR_SET_H
+
+#pragma clang diagnostic pop
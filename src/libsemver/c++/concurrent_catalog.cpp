@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "concurrent_catalog.hpp"
+#include <atomic>
+#include <utility>
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  // The number of catalogs whose last snapshot each thread caches.
+  static const size_t SNAPSHOT_CACHE_SIZE = 8;
+
+  namespace
+  {
+    struct cached_snapshot
+    {
+      uint64_t catalog_id = 0;
+      uint64_t generation = 0;
+      concurrent_catalog::snapshot value;
+    };
+  }
+
+  static thread_local cached_snapshot snapshot_cache[SNAPSHOT_CACHE_SIZE];
+
+  static uint64_t next_catalog_id()
+  {
+    static std::atomic<uint64_t> next_id(1);
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  concurrent_catalog::concurrent_catalog() :
+    concurrent_catalog(catalog())
+  {
+  }
+
+  concurrent_catalog::concurrent_catalog(catalog initial) :
+    id(next_catalog_id()),
+    generation(0),
+    current(std::make_shared<const catalog>(std::move(initial)))
+  {
+  }
+
+  concurrent_catalog::snapshot concurrent_catalog::get() const
+  {
+    cached_snapshot& cached = snapshot_cache[id % SNAPSHOT_CACHE_SIZE];
+
+    // The acquire load pairs with the release increment of store(): a reader
+    // seeing the generation of its cached snapshot got it after its
+    // publication, and returns it without locking.
+    if (cached.catalog_id == id
+        && cached.generation == generation.load(std::memory_order_acquire))
+      return cached.value;
+
+    std::lock_guard<std::mutex> lock(current_mutex);
+    cached.catalog_id = id;
+    cached.generation = generation.load(std::memory_order_relaxed);
+    cached.value = current;
+
+    return cached.value;
+  }
+
+  void concurrent_catalog::publish(catalog contents)
+  {
+    snapshot s = std::make_shared<const catalog>(std::move(contents));
+
+    std::lock_guard<std::mutex> lock(writer);
+    store(std::move(s));
+  }
+
+  void concurrent_catalog::update(const std::function<void(catalog&)>& modifier)
+  {
+    // The current snapshot cannot change while the writer lock is held, so it
+    // can be read without synchronizing with other writers.
+    std::lock_guard<std::mutex> lock(writer);
+    catalog contents = *get();
+
+    modifier(contents);
+
+    store(std::make_shared<const catalog>(std::move(contents)));
+  }
+
+  size_t concurrent_catalog::insert(std::vector<version> versions)
+  {
+    change c;
+    c.inserted = &versions;
+
+    return apply(c);
+  }
+
+  size_t concurrent_catalog::erase(const std::vector<version>& versions)
+  {
+    change c;
+    c.erased = &versions;
+
+    return apply(c);
+  }
+
+  size_t concurrent_catalog::apply(change& c)
+  {
+    {
+      std::lock_guard<std::mutex> lock(changes_mutex);
+      changes.push_back(&c);
+    }
+
+    // The writer that gets the lock first applies all the queued changes,
+    // including the ones of the writers waiting for the lock, which find
+    // their change already applied.
+    std::lock_guard<std::mutex> lock(writer);
+    std::vector<change *> batch;
+
+    {
+      std::lock_guard<std::mutex> changes_lock(changes_mutex);
+
+      if (!c.done) batch.swap(changes);
+    }
+
+    if (!batch.empty())
+    {
+      std::exception_ptr failure;
+
+      try
+      {
+        catalog contents = *get();
+
+        for (change *p : batch)
+        {
+          if (p->inserted)
+          {
+            for (auto& v : *p->inserted)
+              if (contents.insert(std::move(v))) ++p->count;
+          }
+          else
+          {
+            for (const auto& v : *p->erased)
+              if (contents.erase(v)) ++p->count;
+          }
+        }
+
+        store(std::make_shared<const catalog>(std::move(contents)));
+      }
+      catch (...)
+      {
+        failure = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> changes_lock(changes_mutex);
+
+      for (change *p : batch)
+      {
+        p->done = true;
+        p->failure = failure;
+      }
+    }
+
+    if (c.failure) std::rethrow_exception(c.failure);
+
+    return c.count;
+  }
+
+  void concurrent_catalog::store(snapshot s)
+  {
+    // The previous snapshot is released after the lock, here or by the last
+    // reader still holding it.
+    {
+      std::lock_guard<std::mutex> lock(current_mutex);
+      current.swap(s);
+      generation.fetch_add(1, std::memory_order_release);
+    }
+  }
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the semver::concurrent_catalog class.
+ *
+ * This header defines the semver::concurrent_catalog class, a semver::catalog
+ * shared between many reader threads and updated by publishing snapshots.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_CONCURRENT_CATALOG_H
+#define SEMVER_UTILS_CONCURRENT_CATALOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "catalog.hpp"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief Catalog read concurrently through immutable snapshots.
+   *
+   * Readers obtain the current snapshot, a reference-counted immutable
+   * semver::catalog, and query it for as long as they need without blocking
+   * writers or other readers: a snapshot never changes once published.
+   * Writers build a new catalog and publish it as the current snapshot;
+   * snapshots still in use by readers are released when their last reader
+   * drops them.
+   *
+   * Each publication increments an atomic generation counter, and each
+   * thread caches the last snapshot it got, with its generation, for a few
+   * catalogs.  Getting the snapshot takes no lock as long as the generation
+   * has not changed: a reader locks a mutex only for the first read after a
+   * publication, to copy the new snapshot pointer.  A thread thus keeps a
+   * reference to the snapshot it read last until it reads that catalog
+   * again, or another catalog takes its slot in the cache.
+   *
+   * Writers are serialized with each other, and every update copies the
+   * current catalog: its cost is linear in the size of the catalog, whatever
+   * the number of versions changed.  Concurrent calls to insert() and erase()
+   * are therefore combined: the writer holding the lock applies all the
+   * pending ones to a single copy, which is published once.
+   */
+  class concurrent_catalog
+  {
+  public:
+    /**
+     * @brief Type of the snapshots of the catalog.
+     */
+    using snapshot = std::shared_ptr<const catalog>;
+
+    /**
+     * @brief Constructs an empty catalog.
+     */
+    concurrent_catalog();
+
+    /**
+     * @brief Constructs a catalog whose first snapshot is @p initial.
+     *
+     * @param initial The initial contents of the catalog.
+     */
+    explicit concurrent_catalog(catalog initial);
+
+    concurrent_catalog(const concurrent_catalog&) = delete;
+    concurrent_catalog& operator=(const concurrent_catalog&) = delete;
+
+    /**
+     * @brief Gets the current snapshot.  This function does not block on
+     * writers, and takes no lock unless a snapshot was published since the
+     * calling thread last got one.
+     */
+    snapshot get() const;
+
+    /**
+     * @brief Publishes @p contents as the current snapshot.
+     *
+     * @param contents The new contents of the catalog.
+     */
+    void publish(catalog contents);
+
+    /**
+     * @brief Applies @p modifier to a copy of the current snapshot and
+     * publishes the result.
+     *
+     * The catalog is copied once per call: writers should batch their changes
+     * in a single call.
+     *
+     * @param modifier The function modifying the catalog.  If it throws, no
+     * snapshot is published.
+     */
+    void update(const std::function<void(catalog&)>& modifier);
+
+    /**
+     * @brief Inserts @p versions, possibly in the same copy of the catalog as
+     * concurrent calls to insert() and erase().
+     *
+     * @param versions The versions to insert.
+     * @return The number of versions that were not already in the catalog.
+     * @throws std::bad_alloc if the catalog cannot be copied; no snapshot is
+     * published and all the combined calls fail.
+     */
+    size_t insert(std::vector<version> versions);
+
+    /**
+     * @brief Erases @p versions, possibly in the same copy of the catalog as
+     * concurrent calls to insert() and erase().
+     *
+     * @param versions The versions to erase.
+     * @return The number of versions that were removed.
+     * @throws std::bad_alloc if the catalog cannot be copied; no snapshot is
+     * published and all the combined calls fail.
+     */
+    size_t erase(const std::vector<version>& versions);
+
+  private:
+    // A call to insert() or erase() waiting to be applied.
+    struct change
+    {
+      std::vector<version> *inserted = nullptr;
+      const std::vector<version> *erased = nullptr;
+      size_t count = 0;
+      bool done = false;
+      std::exception_ptr failure;
+    };
+
+    size_t apply(change& c);
+    void store(snapshot s);
+
+    // The identifier of the catalog in the snapshot caches of the threads,
+    // unique for the lifetime of the process.
+    const uint64_t id;
+    std::atomic<uint64_t> generation;
+    snapshot current;
+    mutable std::mutex current_mutex;
+    std::mutex writer;
+    std::mutex changes_mutex;
+    std::vector<change *> changes;
+  };
+}
+
+#endif // SEMVER_UTILS_CONCURRENT_CATALOG_H
+
+#pragma clang diagnostic pop
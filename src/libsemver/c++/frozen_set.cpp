@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "frozen_set.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "../gettext_defs.h"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+  static const uint64_t FNV_PRIME = 1099511628211ULL;
+  static const uint64_t GOLDEN_RATIO = 0x9E3779B97F4A7C15ULL;
+  static const uint32_t SINGLE_KEY = 0x80000000U;
+  // Number of seeds tried for a bucket before the whole function is built
+  // again with another global seed.
+  static const uint32_t MAX_BUCKET_SEEDS = 1U << 20;
+
+  // Finalizer of splitmix64: spreads the bits of x over the whole word.
+  static uint64_t mix(uint64_t x)
+  {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+
+    return x ^ (x >> 31);
+  }
+
+  static void hash_bytes(uint64_t& h, std::string_view s)
+  {
+    for (char c : s)
+    {
+      h ^= static_cast<unsigned char>(c);
+      h *= FNV_PRIME;
+    }
+  }
+
+  // Calls f with the pieces of the key of v: its string representation
+  // without metadata.
+  template<typename F>
+  static void for_each_key_piece(const version& v, F f)
+  {
+    for (unsigned int i = 0; i < v.get_version_count(); ++i)
+    {
+      if (i > 0) f(".");
+      f(v.get_version_view(i));
+    }
+
+    if (!v.is_release())
+    {
+      f("-");
+      f(v.get_prerelease_view());
+    }
+  }
+
+  static uint64_t hash_key(const version& v, uint64_t seed)
+  {
+    uint64_t h = FNV_OFFSET_BASIS ^ seed;
+    for_each_key_piece(v, [&h](std::string_view s) { hash_bytes(h, s); });
+
+    return mix(h);
+  }
+
+  static uint64_t hash_key(std::string_view key, uint64_t seed)
+  {
+    uint64_t h = FNV_OFFSET_BASIS ^ seed;
+    hash_bytes(h, key);
+
+    return mix(h);
+  }
+
+  static bool key_equals(std::string_view key, const version& v)
+  {
+    bool equal = true;
+
+    for_each_key_piece(v,
+                       [&](std::string_view s)
+                       {
+                         if (!equal) return;
+
+                         equal = key.substr(0, s.size()) == s;
+                         key.remove_prefix(std::min(s.size(), key.size()));
+                       });
+
+    return equal && key.empty();
+  }
+
+  static size_t bucket_of(uint64_t hash, size_t bucket_count)
+  {
+    return (hash >> 32) % bucket_count;
+  }
+
+  static size_t slot_of(uint64_t hash, uint32_t bucket_seed, size_t count)
+  {
+    return mix(hash ^ (bucket_seed * GOLDEN_RATIO)) % count;
+  }
+
+  // Builds the seeds of the buckets for the specified keys.  Returns false if
+  // a bucket cannot be placed, in which case the global seed is changed.
+  static bool build_buckets(const std::vector<std::string>& keys,
+                            uint64_t seed,
+                            std::vector<uint32_t>& buckets,
+                            std::vector<uint32_t>& slots)
+  {
+    const size_t n = keys.size();
+    // Buckets hold three keys on average: most of them are placed with few
+    // seeds, and single-key buckets, about 15% of the keys, are placed last
+    // into the remaining free slots.
+    buckets.assign(n / 3 + 1, 0);
+
+    std::vector<uint64_t> hashes(n);
+    std::vector<uint32_t> sizes(buckets.size(), 0);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      hashes[i] = hash_key(keys[i], seed);
+      ++sizes[bucket_of(hashes[i], buckets.size())];
+    }
+
+    // Group the keys by bucket, and process the largest buckets first.
+    std::vector<uint32_t> first(buckets.size() + 1, 0);
+    for (size_t b = 0; b < buckets.size(); ++b) first[b + 1] = first[b] + sizes[b];
+
+    std::vector<uint32_t> members(n);
+    std::vector<uint32_t> fill(first.begin(), first.end() - 1);
+    for (size_t i = 0; i < n; ++i)
+      members[fill[bucket_of(hashes[i], buckets.size())]++] = i;
+
+    std::vector<uint32_t> order(buckets.size());
+    for (size_t b = 0; b < order.size(); ++b) order[b] = b;
+    std::stable_sort(order.begin(),
+                     order.end(),
+                     [&sizes](uint32_t lh, uint32_t rh)
+                     {
+                       return sizes[lh] > sizes[rh];
+                     });
+
+    std::vector<bool> taken(n, false);
+    std::vector<size_t> candidate;
+    slots.assign(n, 0);
+
+    size_t b_index = 0;
+
+    for (; b_index < order.size() && sizes[order[b_index]] > 1; ++b_index)
+    {
+      const uint32_t b = order[b_index];
+      uint32_t d = 0;
+
+      for (; d < MAX_BUCKET_SEEDS; ++d)
+      {
+        candidate.clear();
+
+        for (uint32_t m = first[b]; m < first[b + 1]; ++m)
+        {
+          size_t s = slot_of(hashes[members[m]], d, n);
+
+          if (taken[s]
+              || std::find(candidate.begin(), candidate.end(), s)
+                 != candidate.end())
+            break;
+
+          candidate.push_back(s);
+        }
+
+        if (candidate.size() == sizes[b]) break;
+      }
+
+      if (d == MAX_BUCKET_SEEDS) return false;
+
+      buckets[b] = d;
+
+      for (uint32_t m = first[b]; m < first[b + 1]; ++m)
+      {
+        size_t s = candidate[m - first[b]];
+        taken[s] = true;
+        slots[members[m]] = s;
+      }
+    }
+
+    // The keys of single-key buckets are placed directly.
+    size_t free_slot = 0;
+
+    for (; b_index < order.size() && sizes[order[b_index]] == 1; ++b_index)
+    {
+      const uint32_t b = order[b_index];
+
+      while (taken[free_slot]) ++free_slot;
+
+      taken[free_slot] = true;
+      buckets[b] = SINGLE_KEY | static_cast<uint32_t>(free_slot);
+      slots[members[first[b]]] = free_slot;
+    }
+
+    return true;
+  }
+
+  frozen_set::frozen_set(const std::vector<version>& versions)
+  {
+    std::vector<std::string> unique;
+    unique.reserve(versions.size());
+
+    for (const auto& v : versions)
+    {
+      std::string key;
+      for_each_key_piece(v, [&key](std::string_view s) { key += s; });
+      unique.push_back(std::move(key));
+    }
+
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+    if (unique.empty()) return;
+
+    size_t total = 0;
+    for (const auto& k : unique) total += k.size();
+
+    if (unique.size() >= SINGLE_KEY
+        || total > std::numeric_limits<uint32_t>::max())
+      throw std::length_error(_("Too many versions."));
+
+    std::vector<uint32_t> slots;
+
+    while (!build_buckets(unique, seed, buckets, slots)) ++seed;
+
+    std::vector<uint32_t> by_slot(unique.size());
+    for (size_t i = 0; i < unique.size(); ++i) by_slot[slots[i]] = i;
+
+    keys.reserve(total);
+    offsets.reserve(unique.size() + 1);
+
+    for (uint32_t i : by_slot)
+    {
+      keys += unique[i];
+      offsets.push_back(static_cast<uint32_t>(keys.size()));
+    }
+  }
+
+  size_t frozen_set::slot(uint64_t hash) const
+  {
+    uint32_t b = buckets[bucket_of(hash, buckets.size())];
+
+    if (b & SINGLE_KEY) return b & ~SINGLE_KEY;
+
+    return slot_of(hash, b, size());
+  }
+
+  std::string_view frozen_set::key(size_t slot) const
+  {
+    return std::string_view(keys).substr(offsets[slot],
+                                         offsets[slot + 1] - offsets[slot]);
+  }
+
+  bool frozen_set::contains(const version& v) const
+  {
+    if (empty()) return false;
+
+    return key_equals(key(slot(hash_key(v, seed))), v);
+  }
+
+  size_t frozen_set::size() const
+  {
+    return offsets.size() - 1;
+  }
+
+  bool frozen_set::empty() const
+  {
+    return size() == 0;
+  }
+
+  size_t frozen_set::memory_usage() const
+  {
+    return sizeof(*this)
+           + buckets.capacity() * sizeof(uint32_t)
+           + keys.capacity()
+           + offsets.capacity() * sizeof(uint32_t);
+  }
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the semver::frozen_set class.
+ *
+ * This header defines the semver::frozen_set class, an immutable set of
+ * versions indexed by a minimal perfect hash function.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_FROZEN_SET_H
+#define SEMVER_UTILS_FROZEN_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "version.hpp"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief Immutable set of versions with constant-time membership tests.
+   *
+   * A frozen_set is built once from a list of versions and then only queried.
+   * Versions are considered equal when semver::version::operator==() says
+   * so: metadata is ignored, and versions differing only by their metadata
+   * are stored once.
+   *
+   * Versions are indexed by a minimal perfect hash function built with the
+   * _hash and displace_ algorithm: keys are hashed into buckets of a few keys,
+   * and each bucket stores the seed that sends its keys to distinct free
+   * slots of a table with exactly one slot per version.  A lookup hashes
+   * the version once, reads the seed of its bucket and compares the version
+   * with the only candidate.  Besides the versions themselves, stored as
+   * concatenated strings, the index takes less than 6 bytes per version.
+   */
+  class frozen_set
+  {
+  public:
+    /**
+     * @brief Constructs an empty set.
+     */
+    frozen_set() = default;
+
+    /**
+     * @brief Constructs the set of @p versions.
+     *
+     * @param versions The versions of the set.
+     */
+    explicit frozen_set(const std::vector<version>& versions);
+
+    /**
+     * @brief Checks whether the set contains a version equal to @p v.
+     */
+    bool contains(const version& v) const;
+
+    /**
+     * @brief Gets the number of versions of the set.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether the set is empty.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Gets the number of bytes used by the set.
+     */
+    size_t memory_usage() const;
+
+  private:
+    size_t slot(uint64_t hash) const;
+    std::string_view key(size_t slot) const;
+
+    uint64_t seed = 0;
+    // Seed of each bucket.  If the high bit is set, the bucket has a single
+    // key, whose slot is given by the other bits.
+    std::vector<uint32_t> buckets;
+    // Versions without metadata, concatenated in slot order: slot i spans
+    // [offsets[i], offsets[i + 1]).
+    std::string keys;
+    std::vector<uint32_t> offsets{0};
+  };
+}
+
+#endif // SEMVER_UTILS_FROZEN_SET_H
+
+#pragma clang diagnostic pop
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "identifier_scan.hpp"
+#if defined(__SSE2__) && defined(__GNUC__)
+#  include <immintrin.h>
+#  define SEMVER_IDENTIFIER_SSE2
+#  if defined(__x86_64__) || defined(__i386__)
+#    define SEMVER_IDENTIFIER_AVX2
+#  endif
+#endif
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  static bool is_identifier_char(char c)
+  {
+    return (c >= '0' && c <= '9')
+           || (c >= 'a' && c <= 'z')
+           || (c >= 'A' && c <= 'Z')
+           || c == '-';
+  }
+
+  static size_t find_non_identifier_char_scalar(std::string_view s, size_t pos)
+  {
+    while (pos < s.size() && is_identifier_char(s[pos])) ++pos;
+
+    return pos;
+  }
+
+  // A byte is an identifier character if it is a digit, a letter or a hyphen.
+  // Ranges are tested with unsigned comparisons: b is in [lo, lo + n] if the
+  // unsigned difference b - lo is at most n, that is, if min(b - lo, n) equals
+  // b - lo.  Setting bit 5 maps upper case letters to lower case ones without
+  // mapping any other byte into [a-z].
+#ifdef SEMVER_IDENTIFIER_SSE2
+  static size_t find_non_identifier_char_sse2(std::string_view s, size_t pos)
+  {
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i a = _mm_set1_epi8('a');
+    const __m128i letters = _mm_set1_epi8(25);
+    const __m128i hyphen = _mm_set1_epi8('-');
+
+    while (pos + 16 <= s.size())
+    {
+      __m128i block = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(s.data() + pos));
+      __m128i digit = _mm_sub_epi8(block, zero);
+      __m128i alpha = _mm_sub_epi8(_mm_or_si128(block, case_bit), a);
+      __m128i valid = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(digit, nine), digit),
+                     _mm_cmpeq_epi8(_mm_min_epu8(alpha, letters), alpha)),
+        _mm_cmpeq_epi8(block, hyphen));
+      int mask = ~_mm_movemask_epi8(valid) & 0xFFFF;
+
+      if (mask != 0) return pos + __builtin_ctz(mask);
+
+      pos += 16;
+    }
+
+    return find_non_identifier_char_scalar(s, pos);
+  }
+#endif
+
+#ifdef SEMVER_IDENTIFIER_AVX2
+  __attribute__((target("avx2")))
+  static size_t find_non_identifier_char_avx2(std::string_view s, size_t pos)
+  {
+    const __m256i zero = _mm256_set1_epi8('0');
+    const __m256i nine = _mm256_set1_epi8(9);
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i a = _mm256_set1_epi8('a');
+    const __m256i letters = _mm256_set1_epi8(25);
+    const __m256i hyphen = _mm256_set1_epi8('-');
+
+    while (pos + 32 <= s.size())
+    {
+      __m256i block = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(s.data() + pos));
+      __m256i digit = _mm256_sub_epi8(block, zero);
+      __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(block, case_bit), a);
+      __m256i valid = _mm256_or_si256(
+        _mm256_or_si256(
+          _mm256_cmpeq_epi8(_mm256_min_epu8(digit, nine), digit),
+          _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, letters), alpha)),
+        _mm256_cmpeq_epi8(block, hyphen));
+      unsigned int mask = ~static_cast<unsigned int>(
+        _mm256_movemask_epi8(valid));
+
+      if (mask != 0) return pos + __builtin_ctz(mask);
+
+      pos += 32;
+    }
+
+    return find_non_identifier_char_sse2(s, pos);
+  }
+#endif
+
+  size_t find_non_identifier_char(std::string_view s, size_t pos)
+  {
+    // Short strings, such as most identifiers, are not worth a vector load.
+    if (s.size() - pos < 16) return find_non_identifier_char_scalar(s, pos);
+
+#ifdef SEMVER_IDENTIFIER_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+
+    if (has_avx2) return find_non_identifier_char_avx2(s, pos);
+#endif
+#ifdef SEMVER_IDENTIFIER_SSE2
+    return find_non_identifier_char_sse2(s, pos);
+#else
+    return find_non_identifier_char_scalar(s, pos);
+#endif
+  }
+
+  bool is_identifier_sequence(std::string_view s, bool prerelease)
+  {
+    size_t begin = 0;
+
+    for (;;)
+    {
+      size_t end = find_non_identifier_char(s, begin);
+
+      if (end == begin) return false;
+
+      // Numeric identifiers cannot have leading zeroes.  Only identifiers
+      // starting with 0 need to be looked at again.
+      if (prerelease && s[begin] == '0' && end - begin > 1)
+      {
+        size_t i = begin + 1;
+        while (i < end && s[i] >= '0' && s[i] <= '9') ++i;
+
+        if (i == end) return false;
+      }
+
+      if (end == s.size()) return true;
+      if (s[end] != '.') return false;
+
+      begin = end + 1;
+    }
+  }
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the identifier scanning functions.
+ *
+ * This internal header declares the functions used by the parser to validate
+ * prerelease and metadata identifiers.  It is not installed.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_IDENTIFIER_SCAN_H
+#define SEMVER_UTILS_IDENTIFIER_SCAN_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace semver
+{
+  /**
+   * @brief Finds the first character at or after @p pos that cannot be part of
+   * an identifier, that is, that is not in `[0-9A-Za-z-]`.
+   *
+   * Characters are classified in blocks of 32 bytes with AVX2 when the CPU
+   * supports it, or of 16 bytes with SSE2, and one at a time otherwise.
+   *
+   * @return The position of the character, or the size of @p s if there is
+   * none.
+   */
+  size_t find_non_identifier_char(std::string_view s, size_t pos = 0);
+
+  /**
+   * @brief Checks whether @p s is a sequence of dot-separated identifiers.
+   *
+   * @param s The string to check.
+   * @param prerelease Whether numeric identifiers must not have leading
+   * zeroes, as prerelease identifiers.
+   * @return `true` if @p s is valid, `false` otherwise.
+   */
+  bool is_identifier_sequence(std::string_view s, bool prerelease);
+}
+
+#endif // SEMVER_UTILS_IDENTIFIER_SCAN_H
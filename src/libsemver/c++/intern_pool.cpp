@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "intern_pool.hpp"
+#include <cstring>
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  std::string_view intern_pool::intern(std::string_view s)
+  {
+    auto it = strings.find(s);
+    if (it != strings.end()) return *it;
+
+    // The copy is allocated even for an empty string, so that its view is
+    // never null.
+    char *copy = static_cast<char *>(storage.allocate(s.size() + 1, 1));
+    std::memcpy(copy, s.data(), s.size());
+    copy[s.size()] = '\0';
+
+    return *strings.emplace(copy, s.size()).first;
+  }
+
+  size_t intern_pool::size() const
+  {
+    return strings.size();
+  }
+
+  bool intern_pool::empty() const
+  {
+    return strings.empty();
+  }
+
+  void intern_pool::clear()
+  {
+    strings.clear();
+    storage.release();
+  }
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the semver::intern_pool class.
+ *
+ * This header defines the semver::intern_pool class, a pool of immutable
+ * strings shared by many versions.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_INTERN_POOL_H
+#define SEMVER_UTILS_INTERN_POOL_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_set>
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief Pool of interned strings.
+   *
+   * A pool keeps a single immutable copy of each distinct string interned
+   * into it.  The versions parsed by semver::version::from_string() with a
+   * pool share their prerelease and metadata strings, which in large
+   * catalogs repeat many times (`alpha`, `beta.1`, `SNAPSHOT`), and compare
+   * equal ones by address.
+   *
+   * The copies are allocated in blocks and are released when the pool is
+   * destroyed: a pool must outlive the versions that use it.  A pool is not
+   * thread-safe.
+   */
+  class intern_pool
+  {
+  public:
+    /**
+     * @brief Constructs an empty pool.
+     */
+    intern_pool() = default;
+
+    intern_pool(const intern_pool&) = delete;
+    intern_pool& operator=(const intern_pool&) = delete;
+
+    /**
+     * @brief Interns @p s.
+     *
+     * @param s The string to intern.
+     * @return A view of the copy of @p s owned by the pool, which is the same
+     * for all the strings equal to @p s.
+     */
+    std::string_view intern(std::string_view s);
+
+    /**
+     * @brief Gets the number of distinct strings of the pool.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether the pool is empty.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Removes all the strings of the pool and releases their memory.
+     *
+     * The views returned by intern() are invalidated.
+     */
+    void clear();
+
+  private:
+    std::pmr::monotonic_buffer_resource storage;
+    std::unordered_set<std::string_view> strings;
+  };
+}
+
+#endif // SEMVER_UTILS_INTERN_POOL_H
+
+#pragma clang diagnostic pop
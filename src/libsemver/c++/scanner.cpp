@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scanner.hpp"
+#if defined(__SSE2__) && defined(__GNUC__)
+#  include <emmintrin.h>
+#  define SEMVER_SCANNER_SSE2
+#endif
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  static const size_t npos = std::string_view::npos;
+
+  static bool is_digit(char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+  static bool is_alnum(char c)
+  {
+    return is_digit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+  }
+
+  static bool is_identifier_char(char c)
+  {
+    return is_alnum(c) || c == '-';
+  }
+
+  // Finds the first digit at or after pos.  Most of the bytes of a log are not
+  // digits: they are skipped 16 at a time when SSE2 is available.
+  static size_t find_digit(std::string_view text, size_t pos)
+  {
+#ifdef SEMVER_SCANNER_SSE2
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+
+    while (pos + 16 <= text.size())
+    {
+      __m128i block = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(text.data() + pos));
+      // A byte is a digit if its unsigned distance from '0' is at most 9.
+      __m128i offset = _mm_sub_epi8(block, zero);
+      __m128i digits = _mm_cmpeq_epi8(_mm_min_epu8(offset, nine), offset);
+      int mask = _mm_movemask_epi8(digits);
+
+      if (mask != 0) return pos + __builtin_ctz(mask);
+
+      pos += 16;
+    }
+#endif
+
+    while (pos < text.size() && !is_digit(text[pos])) ++pos;
+
+    return pos;
+  }
+
+  // Matches a numeric version component, without leading zeroes.
+  static size_t match_number(std::string_view text, size_t pos)
+  {
+    size_t end = pos;
+    while (end < text.size() && is_digit(text[end])) ++end;
+
+    if (end == pos) return npos;
+    if (text[pos] == '0' && end - pos > 1) return npos;
+
+    return end;
+  }
+
+  // Matches a prerelease or metadata identifier.  Numeric prerelease
+  // identifiers cannot contain leading zeroes.
+  static size_t match_identifier(std::string_view text,
+                                 size_t pos,
+                                 bool prerelease)
+  {
+    size_t end = pos;
+    bool numeric = true;
+
+    while (end < text.size() && is_identifier_char(text[end]))
+    {
+      if (!is_digit(text[end])) numeric = false;
+      ++end;
+    }
+
+    if (end == pos) return npos;
+    if (prerelease && numeric && text[pos] == '0' && end - pos > 1) return npos;
+
+    return end;
+  }
+
+  // Matches the longest sequence of dot-separated identifiers.
+  static size_t match_identifiers(std::string_view text,
+                                  size_t pos,
+                                  bool prerelease)
+  {
+    size_t end = match_identifier(text, pos, prerelease);
+    if (end == npos) return npos;
+
+    while (end < text.size() && text[end] == '.')
+    {
+      size_t next = match_identifier(text, end + 1, prerelease);
+      if (next == npos) break;
+
+      end = next;
+    }
+
+    return end;
+  }
+
+  // Matches the longest version number starting at pos, applying the rules of
+  // the regular expression used by version::from_string().
+  static size_t match_version(std::string_view text, size_t pos)
+  {
+    // Dotted sequences of more than three numbers, such as 1.2.3.4 or IP
+    // addresses, are not versions: neither their head nor their tail matches.
+    if (pos >= 2 && text[pos - 1] == '.' && is_digit(text[pos - 2]))
+      return npos;
+
+    size_t end = match_number(text, pos);
+
+    for (int i = 1; i < 3 && end != npos; ++i)
+    {
+      if (end >= text.size() || text[end] != '.') return npos;
+      end = match_number(text, end + 1);
+    }
+
+    if (end == npos) return npos;
+    if (end < text.size() && is_alnum(text[end])) return npos;
+    if (end + 1 < text.size() && text[end] == '.' && is_digit(text[end + 1]))
+      return npos;
+
+    size_t accepted = end;
+
+    if (end < text.size() && text[end] == '-')
+    {
+      end = match_identifiers(text, end + 1, true);
+      if (end == npos) return accepted;
+
+      accepted = end;
+    }
+
+    if (end < text.size() && text[end] == '+')
+    {
+      end = match_identifiers(text, end + 1, false);
+      if (end != npos) accepted = end;
+    }
+
+    return accepted;
+  }
+
+  scanner::scanner(std::string_view text) :
+    text(text)
+  {
+  }
+
+  bool scanner::next(std::string_view& match)
+  {
+    while (pos < text.size())
+    {
+      // Candidates start at the beginning of a sequence of digits: the
+      // previous match and the previous candidate, if any, end before it.
+      size_t start = find_digit(text, pos);
+      if (start == text.size()) break;
+
+      size_t end = match_version(text, start);
+
+      if (end != npos)
+      {
+        match = text.substr(start, end - start);
+        pos = end;
+        return true;
+      }
+
+      pos = start;
+      while (pos < text.size() && is_digit(text[pos])) ++pos;
+    }
+
+    pos = text.size();
+    return false;
+  }
+
+  std::vector<std::string_view> find_versions(std::string_view text)
+  {
+    std::vector<std::string_view> matches;
+    scanner s(text);
+    std::string_view match;
+
+    while (s.next(match)) matches.push_back(match);
+
+    return matches;
+  }
+}
+
+#pragma clang diagnostic pop
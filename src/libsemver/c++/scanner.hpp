@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the semver::scanner class.
+ *
+ * This header defines the semver::scanner class, which finds version numbers
+ * embedded in arbitrary text such as build logs and lock files.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_SCANNER_H
+#define SEMVER_UTILS_SCANNER_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief Class that finds the version numbers contained in a text.
+   *
+   * The text is scanned once, from left to right.  A match starts at the
+   * beginning of a sequence of digits and is the longest substring starting
+   * there that semver::version::from_string() would accept and that is not
+   * immediately followed by a letter or a digit.  The numbers of a match are
+   * not part of a longer dotted sequence of numbers: `1.2.3.4` and
+   * `192.168.1.10` contain no matches.  For example, the text
+   * `pkg-v1.2.3-rc.1+b7, 1.0.0.` contains the matches `1.2.3-rc.1+b7` and
+   * `1.0.0`.
+   *
+   * Matches are views into the scanned text, which must outlive the scanner.
+   */
+  class scanner
+  {
+  public:
+    /**
+     * @brief Constructs a scanner over @p text.
+     *
+     * @param text The text to scan.
+     */
+    explicit scanner(std::string_view text);
+
+    /**
+     * @brief Finds the next version number.
+     *
+     * @param match The view the match is stored into.
+     * @return `true` if a version number was found, `false` if the end of the
+     * text has been reached.
+     */
+    bool next(std::string_view& match);
+
+  private:
+    std::string_view text;
+    size_t pos = 0;
+  };
+
+  /**
+   * @brief Finds all the version numbers contained in @p text.
+   *
+   * @param text The text to scan.
+   * @return The matches, in the order they appear in @p text.
+   * @see semver::scanner
+   */
+  std::vector<std::string_view> find_versions(std::string_view text);
+}
+
+#endif // SEMVER_UTILS_SCANNER_H
+
+#pragma clang diagnostic pop
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "validation.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  namespace
+  {
+    // Character classes of the automaton.
+    enum char_class : uint8_t
+    {
+      C_ZERO,    // 0
+      C_DIGIT,   // 1-9
+      C_ALPHA,   // a-z, A-Z
+      C_HYPHEN,  // -
+      C_DOT,     // .
+      C_PLUS,    // +
+      C_OTHER,
+      CLASS_COUNT
+    };
+
+    // States of the automaton.  S_MAJOR, S_MINOR, S_PATCH, S_PRERELEASE and
+    // S_METADATA expect the first character of a component or identifier.
+    // Numeric components cannot have leading zeroes, and neither can numeric
+    // prerelease identifiers: an identifier starting with 0 and followed by
+    // digits is only valid if a letter or a hyphen follows.
+    enum state : uint8_t
+    {
+      S_REJECT,
+      S_MAJOR,
+      S_MAJOR_ZERO,
+      S_MAJOR_NUMBER,
+      S_MINOR,
+      S_MINOR_ZERO,
+      S_MINOR_NUMBER,
+      S_PATCH,
+      S_PATCH_ZERO,
+      S_PATCH_NUMBER,
+      S_PRERELEASE,
+      S_PRERELEASE_ZERO,
+      S_PRERELEASE_NUMBER,
+      S_PRERELEASE_LEADING_ZERO,
+      S_PRERELEASE_ALNUM,
+      S_METADATA,
+      S_METADATA_ID,
+      STATE_COUNT
+    };
+
+    using transition_table =
+      std::array<std::array<uint8_t, CLASS_COUNT>, STATE_COUNT>;
+
+    constexpr std::array<uint8_t, 256> make_classes()
+    {
+      std::array<uint8_t, 256> classes{};
+
+      for (size_t c = 0; c < classes.size(); ++c) classes[c] = C_OTHER;
+      for (size_t c = '1'; c <= '9'; ++c) classes[c] = C_DIGIT;
+      for (size_t c = 'a'; c <= 'z'; ++c) classes[c] = C_ALPHA;
+      for (size_t c = 'A'; c <= 'Z'; ++c) classes[c] = C_ALPHA;
+      classes['0'] = C_ZERO;
+      classes['-'] = C_HYPHEN;
+      classes['.'] = C_DOT;
+      classes['+'] = C_PLUS;
+
+      return classes;
+    }
+
+    constexpr void set(transition_table& t,
+                       state from,
+                       std::initializer_list<char_class> on,
+                       state to)
+    {
+      for (char_class c : on) t[from][c] = to;
+    }
+
+    constexpr transition_table make_transitions()
+    {
+      transition_table t{};
+      const auto digits = {C_ZERO, C_DIGIT};
+      const auto identifier = {C_ZERO, C_DIGIT, C_ALPHA, C_HYPHEN};
+      const auto letters = {C_ALPHA, C_HYPHEN};
+
+      set(t, S_MAJOR, {C_ZERO}, S_MAJOR_ZERO);
+      set(t, S_MAJOR, {C_DIGIT}, S_MAJOR_NUMBER);
+      set(t, S_MAJOR_ZERO, {C_DOT}, S_MINOR);
+      set(t, S_MAJOR_NUMBER, digits, S_MAJOR_NUMBER);
+      set(t, S_MAJOR_NUMBER, {C_DOT}, S_MINOR);
+
+      set(t, S_MINOR, {C_ZERO}, S_MINOR_ZERO);
+      set(t, S_MINOR, {C_DIGIT}, S_MINOR_NUMBER);
+      set(t, S_MINOR_ZERO, {C_DOT}, S_PATCH);
+      set(t, S_MINOR_NUMBER, digits, S_MINOR_NUMBER);
+      set(t, S_MINOR_NUMBER, {C_DOT}, S_PATCH);
+
+      set(t, S_PATCH, {C_ZERO}, S_PATCH_ZERO);
+      set(t, S_PATCH, {C_DIGIT}, S_PATCH_NUMBER);
+      set(t, S_PATCH_NUMBER, digits, S_PATCH_NUMBER);
+
+      for (state s : {S_PATCH_ZERO, S_PATCH_NUMBER})
+      {
+        set(t, s, {C_HYPHEN}, S_PRERELEASE);
+        set(t, s, {C_PLUS}, S_METADATA);
+      }
+
+      set(t, S_PRERELEASE, {C_ZERO}, S_PRERELEASE_ZERO);
+      set(t, S_PRERELEASE, {C_DIGIT}, S_PRERELEASE_NUMBER);
+      set(t, S_PRERELEASE, letters, S_PRERELEASE_ALNUM);
+      set(t, S_PRERELEASE_ZERO, digits, S_PRERELEASE_LEADING_ZERO);
+      set(t, S_PRERELEASE_NUMBER, digits, S_PRERELEASE_NUMBER);
+      set(t, S_PRERELEASE_LEADING_ZERO, digits, S_PRERELEASE_LEADING_ZERO);
+      set(t, S_PRERELEASE_ALNUM, identifier, S_PRERELEASE_ALNUM);
+
+      for (state s : {S_PRERELEASE_ZERO,
+                      S_PRERELEASE_NUMBER,
+                      S_PRERELEASE_LEADING_ZERO})
+        set(t, s, letters, S_PRERELEASE_ALNUM);
+
+      for (state s : {S_PRERELEASE_ZERO,
+                      S_PRERELEASE_NUMBER,
+                      S_PRERELEASE_ALNUM})
+      {
+        set(t, s, {C_DOT}, S_PRERELEASE);
+        set(t, s, {C_PLUS}, S_METADATA);
+      }
+
+      set(t, S_METADATA, identifier, S_METADATA_ID);
+      set(t, S_METADATA_ID, identifier, S_METADATA_ID);
+      set(t, S_METADATA_ID, {C_DOT}, S_METADATA);
+
+      return t;
+    }
+
+    constexpr std::array<uint8_t, 256> classes = make_classes();
+    constexpr transition_table transitions = make_transitions();
+
+    constexpr bool is_accepting(uint8_t s)
+    {
+      return s == S_PATCH_ZERO
+             || s == S_PATCH_NUMBER
+             || s == S_PRERELEASE_ZERO
+             || s == S_PRERELEASE_NUMBER
+             || s == S_PRERELEASE_ALNUM
+             || s == S_METADATA_ID;
+    }
+  }
+
+  bool is_valid(std::string_view v)
+  {
+    uint8_t s = S_MAJOR;
+
+    // S_REJECT only transitions to itself, so the loop does not need to test
+    // for it.
+    for (char c : v)
+      s = transitions[s][classes[static_cast<unsigned char>(c)]];
+
+    return is_accepting(s);
+  }
+}
+
+#pragma clang diagnostic pop
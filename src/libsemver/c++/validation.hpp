@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the version validation functions.
+ *
+ * This header declares semver::is_valid(), which checks whether a string is a
+ * valid version number without parsing it.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_VALIDATION_H
+#define SEMVER_UTILS_VALIDATION_H
+
+#include <string_view>
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief Checks whether @p v is a valid version number.
+   *
+   * A string is valid if and only if semver::version::from_string() accepts
+   * it.  The check runs a deterministic automaton over the grammar of
+   * _Semantic Versioning 2.0.0_, including the rules on leading zeroes: each
+   * character is read once, and no memory is allocated.
+   *
+   * @param v The string to check.
+   * @return `true` if @p v is a valid version number, `false` otherwise.
+   */
+  bool is_valid(std::string_view v);
+}
+
+#endif // SEMVER_UTILS_VALIDATION_H
+
+#pragma clang diagnostic pop
@@ -82,9 +82,12 @@
  */
 #include <algorithm>
 #include <iterator> // back_inserter
-#include <regex>
 #include <iostream>
+#include <stdexcept>
+#include <thread> // yield
 #include "../gettext_defs.h"
+#include "identifier_scan.hpp"
+#include "intern_pool.hpp"
 #include "version.hpp"
 
 #pragma clang diagnostic push
@@ -92,19 +95,74 @@
 
 namespace semver
 {
-  static void match_prerelease(const std::string& s);
-  static void match_metadata(const std::string& s);
-  static void check_identifier(const std::string& s);
-  static const std::string PRERELEASE_PATTERN(
-    "([0-9A-Za-z-]+(\\.[0-9A-Za-z-]+)*)");
-  static const std::string METADATA_PATTERN(
-    "([0-9A-Za-z-]+(\\.[0-9A-Za-z-]+)*)");
+  static void match_prerelease(std::string_view s);
+  static void match_metadata(std::string_view s);
+  static void check_prerelease(std::string_view s);
+  static void check_identifier(std::string_view s);
+  static void tokenize_prerelease(
+    std::string_view s,
+    std::pmr::vector<prerelease_token>& components);
+
+  // Numeric identifiers of up to this many digits fit in 64 bits.
+  static const size_t MAX_NUMBER_DIGITS = 19;
+
+  prerelease_token::prerelease_token(std::string_view prerelease,
+                                     size_t offset,
+                                     size_t length) :
+    offset(static_cast<uint32_t>(offset)),
+    length(static_cast<uint32_t>(length)),
+    value(0)
+  {
+    std::string_view id = prerelease.substr(offset, length);
+
+    is_number = !id.empty() && std::all_of(id.begin(), id.end(), ::isdigit);
+
+    if (is_number && id.size() <= MAX_NUMBER_DIGITS)
+      for (char c : id) value = value * 10 + static_cast<uint64_t>(c - '0');
+  }
+
+  std::string_view
+  prerelease_token::identifier(std::string_view prerelease) const
+  {
+    return prerelease.substr(offset, length);
+  }
+
+  int prerelease_token::compare(const prerelease_token& lh,
+                                std::string_view lh_prerelease,
+                                const prerelease_token& rh,
+                                std::string_view rh_prerelease)
+  {
+    if (lh.is_number != rh.is_number) return lh.is_number ? -1 : 1;
+
+    if (lh.is_number)
+    {
+      if (lh.length <= MAX_NUMBER_DIGITS && rh.length <= MAX_NUMBER_DIGITS)
+        return (lh.value < rh.value) ? -1 : (lh.value > rh.value);
+
+      // Numeric identifiers have no leading zeroes: longer ones are greater.
+      if (lh.length != rh.length) return (lh.length < rh.length) ? -1 : 1;
+    }
+
+    return lh.identifier(lh_prerelease).compare(rh.identifier(rh_prerelease));
+  }
 
   prerelease_component::prerelease_component(std::string s) :
-    identifier(std::move(s))
+    identifier(std::move(s)),
+    token(identifier, 0, identifier.size())
   {
-    is_number = !identifier.empty()
-                && std::all_of(identifier.begin(), identifier.end(), ::isdigit);
+  }
+
+  bool prerelease_component::operator<(const prerelease_component& rh) const
+  {
+    return prerelease_token::compare(token,
+                                     identifier,
+                                     rh.token,
+                                     rh.identifier) < 0;
+  }
+
+  bool prerelease_component::operator>(const prerelease_component& rh) const
+  {
+    return (rh < *this);
   }
 
   bool prerelease_component::operator==(const prerelease_component& v) const
@@ -112,186 +170,596 @@ namespace semver
     return identifier == v.identifier;
   }
 
-  bool prerelease_component::operator<(const prerelease_component& rh) const
+  version::text::text(const allocator_type& alloc) :
+    owned(alloc)
   {
-    if (is_number && rh.is_number)
+  }
+
+  version::text::text(std::string_view s, const allocator_type& alloc) :
+    owned(s, alloc)
+  {
+  }
+
+  version::text::text(const text& other, const allocator_type& alloc) :
+    owned(other.view(), alloc)
+  {
+  }
+
+  version::text::text(text&& other, const allocator_type& alloc) :
+    owned(std::move(other.owned), alloc)
+  {
+    if (other.interned.data() == nullptr) return;
+
+    // The move is a copy when the resources differ.
+    if (alloc == other.owned.get_allocator())
+      interned = other.interned;
+    else
+      owned = other.interned;
+  }
+
+  version::text::text(const text& other) :
+    text(other, allocator_type())
+  {
+  }
+
+  version::text& version::text::operator=(const text& other)
+  {
+    if (this != &other) assign(other.view());
+
+    return *this;
+  }
+
+  version::text& version::text::operator=(text&& other)
+  {
+    if (this == &other) return *this;
+
+    if (other.interned.data() == nullptr)
     {
-      // Pad the numeric strings with leading zeros to ensure they have the same length
-      size_t max_length = std::max(identifier.size(), rh.identifier.size());
-      std::string this_padded = std::string(max_length - identifier.size(), '0') + identifier;
-      std::string rh_padded = std::string(max_length - rh.identifier.size(), '0') + rh.identifier;
-      return this_padded < rh_padded;
+      owned = std::move(other.owned);
+      interned = std::string_view();
     }
-    if (!is_number && !rh.is_number) return identifier < rh.identifier;
-    return is_number;
+    else if (owned.get_allocator() == other.owned.get_allocator())
+      share(other.interned);
+    else
+      assign(other.interned);
+
+    return *this;
   }
 
-  bool prerelease_component::operator>(const prerelease_component& rh) const
+  void version::text::assign(std::string_view s)
   {
-    return (rh < *this);
+    owned = s;
+    interned = std::string_view();
   }
 
-  version version::from_string(std::string v)
+  void version::text::share(std::string_view s)
   {
-    // Moving the input parameter in order not to change the API interface
-    // and be efficient.  Be careful _not_ to use the input parameter after
-    // this point.
-    const std::string version = std::move(v);
-    // Using the ECMAScript regular expression grammar to match the version
-    // as specified in https://semver.org/#is-there-a-suggested-regular-expression-regex-to-check-a-semver-string
-    const std::string semver_ecma = "^(0|[1-9]\\d*)\\.(0|[1-9]\\d*)\\.(0|[1-9]\\d*)(?:-((?:0|[1-9]\\d*|\\d*[a-zA-Z-][0-9a-zA-Z-]*)(?:\\.(?:0|[1-9]\\d*|\\d*[a-zA-Z-][0-9a-zA-Z-]*))*))?(?:\\+([0-9a-zA-Z-]+(?:\\.[0-9a-zA-Z-]+)*))?$";
-    std::regex semver_ecma_regexp(semver_ecma, std::regex_constants::ECMAScript);
-    std::smatch ecma_fragments;
-    if (!std::regex_match(version, ecma_fragments, semver_ecma_regexp))
-      throw std::invalid_argument(_("Invalid version: ") + version);
+    owned.clear();
+    interned = s;
+  }
 
-    return semver::version(
-            ecma_fragments[1],
-            ecma_fragments[2],
-            ecma_fragments[3],
-            ecma_fragments[4],
-            ecma_fragments[5]);
+  void version::text::clear()
+  {
+    assign(std::string_view());
   }
 
-  version::version(std::vector<std::string> versions,
-                   std::string prerelease,
-                   std::string metadata) :
-    versions(std::move(versions)),
-    prerelease(std::move(prerelease)),
-    metadata(std::move(metadata))
+  bool version::text::empty() const
   {
-    if (this->versions.size() < 2)
-      throw std::invalid_argument("Version must contain at least two numbers.");
+    return view().empty();
+  }
 
-    if (!this->prerelease.empty())
+  std::string_view version::text::view() const
+  {
+    // A string that was not interned has a null view.
+    return interned.data() != nullptr ? interned : std::string_view(owned);
+  }
+
+  bool version::text::operator==(const text& other) const
+  {
+    std::string_view lh = view();
+    std::string_view rh = other.view();
+
+    if (lh.size() != rh.size()) return false;
+
+    return lh.data() == rh.data() || lh == rh;
+  }
+
+  version::prerelease_tokens::prerelease_tokens(const allocator_type& alloc) :
+    state(EMPTY),
+    components(alloc)
+  {
+  }
+
+  version::prerelease_tokens::prerelease_tokens(const prerelease_tokens& other,
+                                                const allocator_type& alloc) :
+    state(EMPTY),
+    components(alloc)
+  {
+    *this = other;
+  }
+
+  version::prerelease_tokens::prerelease_tokens(prerelease_tokens&& other,
+                                                const allocator_type& alloc) :
+    state(EMPTY),
+    components(alloc)
+  {
+    *this = std::move(other);
+  }
+
+  version::prerelease_tokens::prerelease_tokens(const prerelease_tokens& other) :
+    prerelease_tokens(other, allocator_type())
+  {
+  }
+
+  version::prerelease_tokens::prerelease_tokens(
+    prerelease_tokens&& other) noexcept :
+    state(other.state.load(std::memory_order_acquire)),
+    components(std::move(other.components))
+  {
+    other.clear();
+  }
+
+  version::prerelease_tokens&
+  version::prerelease_tokens::operator=(const prerelease_tokens& other)
+  {
+    if (this == &other) return *this;
+
+    // Components being tokenized by another thread are not copied.
+    if (other.state.load(std::memory_order_acquire) == READY)
     {
-      match_prerelease(this->prerelease);
-      parse_prerelease();
+      components = other.components;
+      state.store(READY, std::memory_order_release);
+    }
+    else
+    {
+      clear();
     }
 
-    if (!this->metadata.empty())
+    return *this;
+  }
+
+  version::prerelease_tokens&
+  version::prerelease_tokens::operator=(prerelease_tokens&& other) noexcept
+  {
+    if (this == &other) return *this;
+
+    if (other.state.load(std::memory_order_acquire) == READY
+        && components.get_allocator() == other.components.get_allocator())
     {
-      match_metadata(this->metadata);
+      components = std::move(other.components);
+      state.store(READY, std::memory_order_release);
     }
+    else
+    {
+      clear();
+    }
+
+    other.clear();
+
+    return *this;
   }
 
-  version::version(std::string major,
-                   std::string minor,
-                   std::string patch,
-                   std::string prerelease,
-                   std::string metadata) :
-    versions{std::move(major), std::move(minor), std::move(patch)},
-    prerelease(std::move(prerelease)),
-    metadata(std::move(metadata))
+  void version::prerelease_tokens::clear()
   {
+    components.clear();
+    state.store(EMPTY, std::memory_order_release);
   }
 
-  std::string version::str() const
+  const std::pmr::vector<prerelease_token>&
+  version::prerelease_tokens::get(std::string_view prerelease) const
   {
-    std::string out = versions[0];
+    for (;;)
+    {
+      uint8_t current = state.load(std::memory_order_acquire);
+
+      if (current == READY) return components;
 
-    for (size_t i = 1; i < versions.size(); ++i)
+      if (current == BUILDING)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      if (!state.compare_exchange_strong(current,
+                                         BUILDING,
+                                         std::memory_order_acquire))
+        continue;
+
+      try
+      {
+        tokenize_prerelease(prerelease, components);
+      }
+      catch (...)
+      {
+        components.clear();
+        state.store(EMPTY, std::memory_order_release);
+        throw;
+      }
+
+      state.store(READY, std::memory_order_release);
+
+      return components;
+    }
+  }
+
+  version version::from_string(std::string_view v, const allocator_type& alloc)
+  {
+    version result(alloc);
+
+    if (!parse(v, nullptr, result))
+      throw std::invalid_argument(_("Invalid version: ") + std::string(v));
+
+    return result;
+  }
+
+  version version::from_string(std::string_view v,
+                               intern_pool& pool,
+                               const allocator_type& alloc)
+  {
+    version result(alloc);
+
+    if (!parse(v, &pool, result))
+      throw std::invalid_argument(_("Invalid version: ") + std::string(v));
+
+    return result;
+  }
+
+  std::optional<version> version::try_from_string(std::string_view v,
+                                                   const allocator_type& alloc)
+  {
+    version result(alloc);
+
+    if (!parse(v, nullptr, result)) return std::nullopt;
+
+    return result;
+  }
+
+  bool version::parse(std::string_view v, intern_pool *pool, version& result)
+  {
+    // The version is matched against the grammar of the regular expression
+    // suggested in https://semver.org/#is-there-a-suggested-regular-expression-regex-to-check-a-semver-string
+    // The numeric components are short and are matched one character at a
+    // time, while the prerelease and the metadata, which may be long, are
+    // classified by blocks of characters.
+    std::string_view numbers[3];
+    size_t pos = 0;
+
+    for (size_t i = 0; i < 3; ++i)
     {
-      out += ".";
-      out += versions[i];
+      if (i > 0)
+      {
+        if (pos == v.size() || v[pos] != '.') return false;
+        ++pos;
+      }
+
+      size_t begin = pos;
+      while (pos < v.size() && v[pos] >= '0' && v[pos] <= '9') ++pos;
+
+      if (pos == begin || (v[begin] == '0' && pos - begin > 1)) return false;
+
+      numbers[i] = v.substr(begin, pos - begin);
     }
 
-    if (!prerelease.empty())
+    std::string_view prerelease;
+    std::string_view metadata;
+
+    if (pos < v.size() && v[pos] == '-')
     {
-      out += "-";
-      out += prerelease;
+      size_t end = std::min(v.find('+', pos), v.size());
+      prerelease = v.substr(pos + 1, end - pos - 1);
+
+      if (!is_identifier_sequence(prerelease, true)) return false;
+
+      pos = end;
     }
 
-    if (!metadata.empty())
+    if (pos < v.size())
+    {
+      if (v[pos] != '+') return false;
+      metadata = v.substr(pos + 1);
+
+      if (!is_identifier_sequence(metadata, false)) return false;
+    }
+
+    // The prerelease identifiers are tokenized only if they are compared.
+    result.versions.reserve(3);
+    for (auto n : numbers) result.versions.emplace_back(n);
+
+    if (pool == nullptr)
     {
-      out += "+";
-      out += metadata;
+      result.prerelease.assign(prerelease);
+      result.metadata.assign(metadata);
     }
+    else
+    {
+      if (!prerelease.empty()) result.prerelease.share(pool->intern(prerelease));
+      if (!metadata.empty()) result.metadata.share(pool->intern(metadata));
+    }
+
+    return true;
+  }
+
+  version::version(const allocator_type& alloc) :
+    versions(alloc),
+    prerelease(alloc),
+    prerelease_comp(alloc),
+    metadata(alloc)
+  {
+  }
+
+  version::version(const std::vector<std::string>& versions,
+                   std::string_view prerelease,
+                   std::string_view metadata,
+                   const allocator_type& alloc) :
+    versions(versions.begin(), versions.end(), alloc),
+    prerelease(prerelease, alloc),
+    prerelease_comp(alloc),
+    metadata(metadata, alloc)
+  {
+    if (this->versions.size() < 2)
+      throw std::invalid_argument("Version must contain at least two numbers.");
+
+    if (!this->prerelease.empty())
+    {
+      match_prerelease(this->prerelease.view());
+      check_prerelease(this->prerelease.view());
+    }
+
+    if (!this->metadata.empty())
+    {
+      match_metadata(this->metadata.view());
+    }
+  }
+
+  version::version(std::string_view major,
+                   std::string_view minor,
+                   std::string_view patch,
+                   std::string_view prerelease,
+                   std::string_view metadata,
+                   const allocator_type& alloc) :
+    version(alloc)
+  {
+    this->versions.reserve(3);
+    this->versions.emplace_back(major);
+    this->versions.emplace_back(minor);
+    this->versions.emplace_back(patch);
+    this->prerelease.assign(prerelease);
+    this->metadata.assign(metadata);
+
+    if (!this->prerelease.empty()) check_prerelease(this->prerelease.view());
+  }
+
+  version::version(trusted,
+                   const component_list& versions,
+                   const text& prerelease,
+                   const prerelease_tokens& prerelease_comp,
+                   const text& metadata,
+                   const allocator_type& alloc) :
+    versions(versions, alloc),
+    prerelease(prerelease, alloc),
+    prerelease_comp(prerelease_comp, alloc),
+    metadata(metadata, alloc)
+  {
+  }
+
+  version::version(const version& other, const allocator_type& alloc) :
+    versions(other.versions, alloc),
+    prerelease(other.prerelease, alloc),
+    prerelease_comp(other.prerelease_comp, alloc),
+    metadata(other.metadata, alloc)
+  {
+  }
+
+  version::version(version&& other, const allocator_type& alloc) :
+    versions(std::move(other.versions), alloc),
+    prerelease(std::move(other.prerelease), alloc),
+    prerelease_comp(std::move(other.prerelease_comp), alloc),
+    metadata(std::move(other.metadata), alloc)
+  {
+  }
+
+  version::version(const version& other,
+                   intern_pool& pool,
+                   const allocator_type& alloc) :
+    versions(other.versions, alloc),
+    prerelease(alloc),
+    prerelease_comp(other.prerelease_comp, alloc),
+    metadata(alloc)
+  {
+    if (!other.prerelease.empty())
+      prerelease.share(pool.intern(other.prerelease.view()));
+
+    if (!other.metadata.empty())
+      metadata.share(pool.intern(other.metadata.view()));
+  }
+
+  version::allocator_type version::get_allocator() const
+  {
+    return versions.get_allocator();
+  }
+
+  std::string version::str() const
+  {
+    std::string out;
+    out.reserve(formatted_size());
+    format_to(std::back_inserter(out));
 
     return out;
   }
 
-  version version::bump_major() const
+  size_t version::formatted_size() const
+  {
+    // Each component but the first is preceded by a dot.
+    size_t size = versions.size() - 1;
+
+    for (const auto& v : versions) size += v.size();
+
+    if (!prerelease.empty()) size += prerelease.view().size() + 1;
+    if (!metadata.empty()) size += metadata.view().size() + 1;
+
+    return size;
+  }
+
+  size_t version::write(char *buf, size_t size) const
+  {
+    size_t required = formatted_size();
+
+    if (required <= size) format_to(buf);
+
+    return required;
+  }
+
+  version version::bump_major() const &
   {
     return bump(0);
   }
 
-  version version::bump_minor() const
+  version version::bump_major() &&
+  {
+    return std::move(*this).bump(0);
+  }
+
+  version version::bump_minor() const &
   {
     return bump(1);
   }
 
-  version version::bump_patch() const
+  version version::bump_minor() &&
+  {
+    return std::move(*this).bump(1);
+  }
+
+  version version::bump_patch() const &
   {
     return bump(2);
   }
 
-  static std::string increment_version_component(const std::string& version_component) {
-    std::string result = version_component;
+  version version::bump_patch() &&
+  {
+    return std::move(*this).bump(2);
+  }
+
+  static void increment_version_component(std::pmr::string& version_component) {
     int carry = 1; // Start with the increment
 
-    for (int i = result.size() - 1; i >= 0 && carry; --i) {
-        if (isdigit(result[i])) {
-            int digit = result[i] - '0' + carry;
+    for (int i = version_component.size() - 1; i >= 0 && carry; --i) {
+        if (isdigit(version_component[i])) {
+            int digit = version_component[i] - '0' + carry;
             carry = digit / 10;
-            result[i] = '0' + (digit % 10);
+            version_component[i] = '0' + (digit % 10);
         } else {
             throw std::invalid_argument("Version component contains non-digit characters");
         }
     }
 
     if (carry) {
-        result.insert(result.begin(), '1');
+        version_component.insert(version_component.begin(), '1');
     }
-
-    return result;
 }
 
-  version version::bump(unsigned int index) const
+  version version::bump(unsigned int index) const &
   {
-    std::vector<std::string> bumped_versions = versions;
+    version bumped(*this, get_allocator());
+    return std::move(bumped).bump(index);
+  }
 
-    if (index >= bumped_versions.size())
+  version version::bump(unsigned int index) &&
+  {
+    // The components are modified in place: bumping a valid version cannot
+    // make it invalid, so the result is not validated again.
+    if (index >= versions.size())
     {
-      std::fill_n(std::back_inserter(bumped_versions),
-                  index - bumped_versions.size() + 1,
-                  std::string("0"));
-      bumped_versions[index] = std::string("1");
+      while (versions.size() < index) versions.emplace_back("0");
+      versions.emplace_back("1");
     }
     else
     {
-      bumped_versions[index] = increment_version_component(bumped_versions[index]);
+      increment_version_component(versions[index]);
 
-      for (size_t i = index + 1; i < bumped_versions.size(); ++i)
-        bumped_versions[i] = "0";
+      for (size_t i = index + 1; i < versions.size(); ++i)
+        versions[i] = "0";
     }
 
-    return version(bumped_versions, prerelease, metadata);
+    return std::move(*this);
+  }
+
+  std::vector<std::string> version::get_version() const
+  {
+    return std::vector<std::string>(versions.begin(), versions.end());
   }
 
-  const std::vector<std::string>& version::get_version() const
+  const version::component_list& version::get_components() const
   {
     return versions;
   }
 
   std::string version::get_prerelease() const
   {
-    return prerelease;
+    return std::string(prerelease.view());
   }
 
   std::string version::get_metadata() const
   {
-    return metadata;
+    return std::string(metadata.view());
+  }
+
+  size_t version::get_version_count() const
+  {
+    return versions.size();
+  }
+
+  std::string_view version::get_version_view(unsigned int index) const
+  {
+    if (index >= versions.size()) return "0";
+
+    return versions[index];
+  }
+
+  std::string_view version::get_prerelease_view() const
+  {
+    return prerelease.view();
+  }
+
+  std::string_view version::get_metadata_view() const
+  {
+    return metadata.view();
+  }
+
+  version version::strip_prerelease() const &
+  {
+    return version(trusted(),
+                   versions,
+                   text(get_allocator()),
+                   prerelease_tokens(get_allocator()),
+                   metadata,
+                   get_allocator());
+  }
+
+  version version::strip_prerelease() &&
+  {
+    prerelease.clear();
+    prerelease_comp.clear();
+
+    return std::move(*this);
   }
 
-  version version::strip_prerelease() const
+  version version::strip_metadata() const &
   {
-    return version(versions, "", metadata);
+    // The prerelease components refer to positions in the prerelease string,
+    // so they remain valid in the copy.
+    return version(trusted(),
+                   versions,
+                   prerelease,
+                   prerelease_comp,
+                   text(get_allocator()),
+                   get_allocator());
   }
 
-  version version::strip_metadata() const
+  version version::strip_metadata() &&
   {
-    return version(versions, prerelease, "");
+    metadata.clear();
+
+    return std::move(*this);
   }
 
   bool version::is_release() const
@@ -299,12 +767,17 @@ namespace semver
     return (prerelease.empty());
   }
 
-  // Helper function to pad strings with leading zeros
-  std::string pad_string(const std::string& str, size_t length) {
-    if (str.size() < length) {
-        return std::string(length - str.size(), '0') + str;
-    }
-    return str;
+  // Compares two numeric components of any length without converting them:
+  // once the leading zeroes are skipped, the longer number is the greater,
+  // and numbers of the same length compare as strings.
+  static int compare_number(std::string_view lh, std::string_view rh)
+  {
+    lh.remove_prefix(std::min(lh.find_first_not_of('0'), lh.size()));
+    rh.remove_prefix(std::min(rh.find_first_not_of('0'), rh.size()));
+
+    if (lh.size() != rh.size()) return (lh.size() < rh.size()) ? -1 : 1;
+
+    return lh.compare(rh);
   }
 
   bool version::operator==(const version& v) const
@@ -314,22 +787,11 @@ namespace semver
 
   bool version::operator<(const version& v) const
   {
-    // Determine the maximum length of version components for padding
-    size_t max_length = 0;
-    for (const auto& s : versions) {
-      max_length = std::max(max_length, s.size());
-    }
-    for (const auto& s : v.versions) {
-      max_length = std::max(max_length, s.size());
-    }
-
-    // Compare version numbers as padded strings
-    for (size_t i = 0; i < std::min(versions.size(), v.versions.size()); ++i) {
-      std::string this_version_padded = pad_string(versions[i], max_length);
-      std::string other_version_padded = pad_string(v.versions[i], max_length);
-
-      if (this_version_padded < other_version_padded) return true;
-      if (this_version_padded > other_version_padded) return false;
+    // Compare version numbers numerically.
+    for (size_t i = 0; i < std::min(versions.size(), v.versions.size()); ++i)
+    {
+      int c = compare_number(versions[i], v.versions[i]);
+      if (c != 0) return c < 0;
     }
 
     // If all compared components are equal, the version with fewer components is smaller.
@@ -343,7 +805,20 @@ namespace semver
     // If either one, but not both, are release versions, release is greater.
     if (is_release() ^ v.is_release()) return !is_release();
 
-    return prerelease_comp < v.prerelease_comp;
+    const auto& lh = prerelease_comp.get(prerelease.view());
+    const auto& rh = v.prerelease_comp.get(v.prerelease.view());
+    size_t common = std::min(lh.size(), rh.size());
+
+    for (size_t i = 0; i < common; ++i)
+    {
+      int c = prerelease_token::compare(lh[i],
+                                        prerelease.view(),
+                                        rh[i],
+                                        v.prerelease.view());
+      if (c != 0) return c < 0;
+    }
+
+    return lh.size() < rh.size();
   }
 
   bool version::operator>(const version& v) const
@@ -355,32 +830,49 @@ namespace semver
   {
     if (index >= versions.size()) return std::string("0");
 
-    return versions[index];
+    return std::string(versions[index]);
   }
 
-  void version::parse_prerelease()
+  static void tokenize_prerelease(
+    std::string_view s,
+    std::pmr::vector<prerelease_token>& components)
   {
-    std::regex separator("\\.");
-    std::sregex_token_iterator first(prerelease.begin(), prerelease.end(), separator, -1);
-    std::sregex_token_iterator last;
+    size_t begin = 0;
 
-    std::for_each(
-      first,
-      last,
-      [this](std::string s)
-      {
-        check_identifier(s);
+    for (;;)
+    {
+      size_t end = std::min(s.find('.', begin), s.size());
+
+      components.emplace_back(s, begin, end - begin);
+
+      if (end == s.size()) break;
+
+      begin = end + 1;
+    }
+  }
+
+  static void check_prerelease(std::string_view s)
+  {
+    size_t begin = 0;
+
+    for (;;)
+    {
+      size_t end = std::min(s.find('.', begin), s.size());
+
+      check_identifier(s.substr(begin, end - begin));
 
-        prerelease_comp.emplace_back(s);
-      });
+      if (end == s.size()) break;
+
+      begin = end + 1;
+    }
   }
 
-  static void check_identifier(const std::string& s)
+  static void check_identifier(std::string_view s)
   {
     if (s.empty())
-      throw std::invalid_argument(_("Invalid identifier: ") + s);
+      throw std::invalid_argument(_("Invalid identifier: ") + std::string(s));
 
-    if (s[0] != '0') return;
+    if (s[0] != '0' || s.size() == 1) return;
 
     for (size_t i = 1; i < s.size(); ++i)
     {
@@ -391,16 +883,18 @@ namespace semver
       _("Numerical identifier cannot contain leading zeroes."));
   }
 
-  static void match_prerelease(const std::string& s)
+  static void match_prerelease(std::string_view s)
   {
-    if (!std::regex_match(s, std::regex(PRERELEASE_PATTERN)))
-      throw std::invalid_argument(_("Invalid prerelease: ") + s);
+    // Leading zeroes are reported by check_identifier() when the identifiers
+    // are parsed.
+    if (!is_identifier_sequence(s, false))
+      throw std::invalid_argument(_("Invalid prerelease: ") + std::string(s));
   }
 
-  static void match_metadata(const std::string& s)
+  static void match_metadata(std::string_view s)
   {
-    if (!std::regex_match(s, std::regex(METADATA_PATTERN)))
-      throw std::invalid_argument(_("Invalid metadata: ") + s);
+    if (!is_identifier_sequence(s, false))
+      throw std::invalid_argument(_("Invalid metadata: ") + std::string(s));
   }
 }
 
@@ -28,8 +28,15 @@
 #ifndef SEMVER_UTILS_VERSION_H
 #define SEMVER_UTILS_VERSION_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
 #include <vector>
 #include <string>
+#include <string_view>
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
@@ -39,25 +46,87 @@
  */
 namespace semver
 {
+  class intern_pool;
+
   /**
-   * @brief Class that represents a prerelease identifier.
+   * @brief Class that represents a prerelease identifier of a version.
    *
-   * This class represents a prerelease identifier complying with _Semantic
-   * Versioning_ 2.0.0 (http://semver.org/).
+   * The identifier is not copied: a token refers to its position in the
+   * prerelease string of the version it belongs to, and the value of numeric
+   * identifiers is precomputed.
    */
-  class prerelease_component
+  class prerelease_token
   {
   private:
+    /**
+     * @brief The position of the identifier in the prerelease string.
+     */
+    uint32_t offset;
+
+    /**
+     * @brief The length of the identifier.
+     */
+    uint32_t length;
+
     /**
      * @brief Indicates whether the component is a number.
      */
     bool is_number;
 
+    /**
+     * @brief The value of a numeric identifier, if it fits in 64 bits.
+     */
+    uint64_t value;
+
+  public:
+    /**
+     * @brief Constructs the token spanning @p length characters from
+     * @p offset in @p prerelease.
+     */
+    prerelease_token(std::string_view prerelease,
+                         size_t offset,
+                         size_t length);
+
+    /**
+     * @brief Gets the identifier of this token.
+     *
+     * @param prerelease The prerelease string this token belongs to.
+     */
+    std::string_view identifier(std::string_view prerelease) const;
+
+    /**
+     * @brief Compares two tokens according to _Semantic Versioning 2.0.0_.
+     *
+     * @return A negative number, zero or a positive number if @p lh has lower,
+     * equal or higher precedence than @p rh, respectively.
+     */
+    static int compare(const prerelease_token& lh,
+                       std::string_view lh_prerelease,
+                       const prerelease_token& rh,
+                       std::string_view rh_prerelease);
+  };
+
+  /**
+   * @brief Class that represents a prerelease identifier.
+   *
+   * This class represents a prerelease identifier complying with _Semantic
+   * Versioning_ 2.0.0 (http://semver.org/).  A component owns a copy of its
+   * identifier, whereas semver::version keeps the identifiers of its
+   * prerelease as semver::prerelease_token views.
+   */
+  class prerelease_component
+  {
+  private:
     /**
      * @brief The component representation as a string.
      */
     std::string identifier;
 
+    /**
+     * @brief The token spanning the whole identifier.
+     */
+    prerelease_token token;
+
   public:
     prerelease_component(std::string s);
     bool operator<(const prerelease_component& rh) const;
@@ -73,30 +142,166 @@ namespace semver
    * version numbers to contain any number of components greater than 2.
    *
    * Instances of this class are designed to be immutable.
+   *
+   * This class is allocator-aware: its components are allocated from the
+   * `std::pmr::memory_resource` of the allocator it is constructed with, the
+   * default resource if none is specified.  For example, the versions parsed
+   * while serving a request can be allocated from a
+   * `std::pmr::monotonic_buffer_resource` and released all at once.  As with
+   * the standard `std::pmr` containers, the resource is not propagated by
+   * copy construction, and containers such as `std::pmr::vector<version>`
+   * pass theirs to the versions they construct.
+   *
+   * The prerelease and metadata strings of the versions parsed with a
+   * semver::intern_pool are not copied into each version, but shared through
+   * the pool.  Copies of such versions own their strings, unless they are
+   * constructed with a pool, and can outlive the pool.
    */
   class version
   {
+  public:
+    /**
+     * @brief The type of the allocator of the components of a version.
+     */
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    /**
+     * @brief The type of the list of the numeric components of a version.
+     */
+    using component_list = std::pmr::vector<std::pmr::string>;
+
   private:
-    std::vector<std::string> versions;
-    std::string prerelease;
-    std::vector<prerelease_component> prerelease_comp;
-    std::string metadata;
+    // A string owned by the version or, if it was interned, by an
+    // intern_pool.  Equal interned strings are compared by address.  Copies
+    // own their string, so that they do not depend on the pool: only a move
+    // within the same resource keeps sharing it.
+    class text
+    {
+    private:
+      std::pmr::string owned;
+      std::string_view interned;
+
+    public:
+      explicit text(const allocator_type& alloc);
+      text(std::string_view s, const allocator_type& alloc);
+      text(const text& other, const allocator_type& alloc);
+      text(text&& other, const allocator_type& alloc);
+      text(const text& other);
+      text(text&&) = default;
+      text& operator=(const text& other);
+      text& operator=(text&& other);
+
+      void assign(std::string_view s);
+      void share(std::string_view s);
+      void clear();
+      bool empty() const;
+      std::string_view view() const;
+      bool operator==(const text& other) const;
+    };
+
+    // The identifiers of the prerelease string, tokenized the first time
+    // they are needed to compare two versions.  Tokenizing is thread-safe:
+    // the first thread builds the components and the others wait for it.
+    class prerelease_tokens
+    {
+    private:
+      enum : uint8_t
+      {
+        EMPTY,
+        BUILDING,
+        READY
+      };
+
+      mutable std::atomic<uint8_t> state;
+      mutable std::pmr::vector<prerelease_token> components;
 
-    void parse_prerelease();
+    public:
+      explicit prerelease_tokens(const allocator_type& alloc);
+      prerelease_tokens(const prerelease_tokens& other,
+                        const allocator_type& alloc);
+      prerelease_tokens(prerelease_tokens&& other, const allocator_type& alloc);
+      prerelease_tokens(const prerelease_tokens& other);
+      prerelease_tokens(prerelease_tokens&& other) noexcept;
+      prerelease_tokens& operator=(const prerelease_tokens& other);
+      prerelease_tokens& operator=(prerelease_tokens&& other) noexcept;
+
+      void clear();
+      const std::pmr::vector<prerelease_token>&
+      get(std::string_view prerelease) const;
+    };
+
+    component_list versions;
+    text prerelease;
+    prerelease_tokens prerelease_comp;
+    text metadata;
+
+    // Tag selecting the constructor that trusts its arguments to be valid.
+    struct trusted
+    {
+    };
+
+    explicit version(const allocator_type& alloc);
+
+    version(trusted,
+            const component_list& versions,
+            const text& prerelease,
+            const prerelease_tokens& prerelease_comp,
+            const text& metadata,
+            const allocator_type& alloc);
+
+    // Parses v into result, a version just constructed with an allocator,
+    // and returns false if v is not valid.
+    static bool parse(std::string_view v, intern_pool *pool, version& result);
 
   public:
     /**
-     * @brief Constructs a semver::version instance from a std::string.
+     * @brief Constructs a semver::version instance from a string.
      *
-     * The version number @p v must comply with _Semantic Versioning 2.0.0_.  As
-     * a supported extension this class allows version numbers to contain any
-     * number of components greater than 2.
+     * The version number @p v must comply with _Semantic Versioning 2.0.0_.
+     * The input is parsed in place: only the components of the resulting
+     * instance are copied.
      *
      * @param v The version number to parse.
+     * @param alloc The allocator of the components of the version.
      * @return A semver::version instance.
      * @throws std::invalid_argument if @p v is not a valid version number.
      */
-    static version from_string(std::string v);
+    static version from_string(std::string_view v,
+                               const allocator_type& alloc = allocator_type());
+
+    /**
+     * @brief Constructs a semver::version instance from a string, interning
+     * its prerelease and metadata strings into @p pool.
+     *
+     * The pool must outlive the returned instance, but not its copies.
+     *
+     * @param v The version number to parse.
+     * @param pool The pool the prerelease and metadata strings are interned
+     * into.
+     * @param alloc The allocator of the components of the version.
+     * @return A semver::version instance.
+     * @throws std::invalid_argument if @p v is not a valid version number.
+     */
+    static version from_string(std::string_view v,
+                               intern_pool& pool,
+                               const allocator_type& alloc = allocator_type());
+
+    /**
+     * @brief Constructs a semver::version instance from a string, if it is a
+     * valid version number.
+     *
+     * This function behaves like from_string(), but reports invalid version
+     * numbers without building an exception: it suits inputs where they are
+     * expected.
+     *
+     * @param v The version number to parse.
+     * @param alloc The allocator of the components of the version.
+     * @return A semver::version instance, or an empty optional if @p v is not
+     * a valid version number.
+     */
+    static std::optional<version>
+    try_from_string(std::string_view v,
+                    const allocator_type& alloc = allocator_type());
 
     /**
      * @brief Constructs a semver::version instance with the specified
@@ -107,13 +312,15 @@ namespace semver
      * than 2.
      * @param prerelease An optional prerelease string.
      * @param metadata An optional metadata string.
+     * @param alloc The allocator of the components of the version.
      * @return A semver::version instance.
      * @throws std::invalid_argument if the parameters do not comply with
      * _Semantic Versioning 2.0.0_.
      */
-    version(std::vector<std::string> versions,
-            std::string prerelease = "",
-            std::string metadata = "");
+    version(const std::vector<std::string>& versions,
+            std::string_view prerelease = "",
+            std::string_view metadata = "",
+            const allocator_type& alloc = allocator_type());
 
     /**
      * @brief Constructs a semver::version instance with the specified
@@ -124,15 +331,50 @@ namespace semver
      * @param patch The patch version.
      * @param prerelease An optional prerelease string.
      * @param metadata An optional metadata string.
+     * @param alloc The allocator of the components of the version.
      * @return A semver::version instance.
      * @throws std::invalid_argument if the parameters do not comply with
      * _Semantic Versioning 2.0.0_.
      */
-    version(std::string major,
-            std::string minor,
-            std::string patch,
-            std::string prerelease = "",
-            std::string metadata = "");
+    version(std::string_view major,
+            std::string_view minor,
+            std::string_view patch,
+            std::string_view prerelease = "",
+            std::string_view metadata = "",
+            const allocator_type& alloc = allocator_type());
+
+    /**
+     * @brief Copies @p other using the specified allocator.
+     */
+    version(const version& other, const allocator_type& alloc);
+
+    /**
+     * @brief Moves @p other using the specified allocator.
+     *
+     * The components are moved only if @p alloc uses the same resource as
+     * @p other, and copied otherwise.
+     */
+    version(version&& other, const allocator_type& alloc);
+
+    /**
+     * @brief Copies @p other, interning its prerelease and metadata strings
+     * into @p pool.
+     *
+     * The pool must outlive the returned instance, but not its copies.
+     */
+    version(const version& other,
+            intern_pool& pool,
+            const allocator_type& alloc = allocator_type());
+
+    version(const version&) = default;
+    version(version&&) = default;
+    version& operator=(const version&) = default;
+    version& operator=(version&&) = default;
+
+    /**
+     * @brief Gets the allocator of the components of this instance.
+     */
+    allocator_type get_allocator() const;
 
     /**
      * @brief Converts a version to its string representation.
@@ -142,11 +384,53 @@ namespace semver
     std::string str() const;
 
     /**
-     * @brief Gets the version components.
+     * @brief Gets the length of the string representation of this instance.
+     *
+     * @return The number of characters written by format_to() and write().
+     */
+    size_t formatted_size() const;
+
+    /**
+     * @brief Writes the string representation of this instance to @p out.
+     *
+     * No temporary string is built, so that many versions can be written into
+     * the same output buffer.
+     *
+     * @param out The output iterator the characters are written to.
+     * @return The iterator past the last character written.
+     */
+    template<typename OutputIt>
+    OutputIt format_to(OutputIt out) const;
+
+    /**
+     * @brief Writes the string representation of this instance to @p buf.
+     *
+     * The representation is not null-terminated.  If it does not fit in
+     * @p size characters, nothing is written.
+     *
+     * @param buf The buffer the characters are written to.
+     * @param size The size of @p buf.
+     * @return The length of the representation, as returned by
+     * formatted_size().
+     */
+    size_t write(char *buf, size_t size) const;
+
+    /**
+     * @brief Gets a copy of the version components.
+     *
+     * get_components() accesses the components without copying them.
      *
      * @return The version components.
      */
-    const std::vector<std::string>& get_version() const;
+    std::vector<std::string> get_version() const;
+
+    /**
+     * @brief Gets the version components.
+     *
+     * @return The version components, allocated from the resource of this
+     * version.
+     */
+    const component_list& get_components() const;
 
     /**
      * @brief Gets the specified version component.
@@ -170,6 +454,41 @@ namespace semver
      */
     std::string get_metadata() const;
 
+    /**
+     * @brief Gets the number of version components.
+     *
+     * @return The number of version components.
+     */
+    size_t get_version_count() const;
+
+    /**
+     * @brief Gets a view of the specified version component.
+     *
+     * The view is valid as long as this instance is not modified or destroyed.
+     *
+     * @return The specified version component, or "0" if the specified @p index
+     * does not exist.
+     */
+    std::string_view get_version_view(unsigned int index) const;
+
+    /**
+     * @brief Gets a view of the prerelease string.
+     *
+     * The view is valid as long as this instance is not modified or destroyed.
+     *
+     * @return The prerelease string.
+     */
+    std::string_view get_prerelease_view() const;
+
+    /**
+     * @brief Gets a view of the metadata string.
+     *
+     * The view is valid as long as this instance is not modified or destroyed.
+     *
+     * @return The metadata string.
+     */
+    std::string_view get_metadata_view() const;
+
     /**
      * @brief Bumps the major version component.
      *
@@ -177,7 +496,13 @@ namespace semver
      *
      * @return A semver::version object containing the bumped version.
      */
-    version bump_major() const;
+    version bump_major() const &;
+
+    /**
+     * @brief Bumps the major version component, reusing the storage of this
+     * instance.
+     */
+    version bump_major() &&;
 
     /**
      * @brief Bumps the minor version component.
@@ -186,7 +511,13 @@ namespace semver
      *
      * @return A semver::version object representing the bumped version.
      */
-    version bump_minor() const;
+    version bump_minor() const &;
+
+    /**
+     * @brief Bumps the minor version component, reusing the storage of this
+     * instance.
+     */
+    version bump_minor() &&;
 
     /**
      * @brief Bumps the patch version component.
@@ -195,7 +526,13 @@ namespace semver
      *
      * @return A semver::version object representing the bumped version.
      */
-    version bump_patch() const;
+    version bump_patch() const &;
+
+    /**
+     * @brief Bumps the patch version component, reusing the storage of this
+     * instance.
+     */
+    version bump_patch() &&;
 
     /**
      * @brief Bumps the specified version component.
@@ -205,23 +542,48 @@ namespace semver
      * `s` of the version number, then `index + 1 - s` components are added and
      * set to 0.
      *
+     * The components of the result are not validated again.
+     *
+     * @return A semver::version object representing the bumped version.
+     */
+    version bump(unsigned int index) const &;
+
+    /**
+     * @brief Bumps the specified version component, reusing the storage of
+     * this instance, which is left in a valid but unspecified state.
+     *
+     * For example, `std::move(v).bump(1)` increments the minor component of
+     * `v` without copying it.
+     *
      * @return A semver::version object representing the bumped version.
      */
-    version bump(unsigned int index) const;
+    version bump(unsigned int index) &&;
 
     /**
      * @brief Strips the prerelease component.
      *
      * @return A semver::version object representing the modified version.
      */
-    version strip_prerelease() const;
+    version strip_prerelease() const &;
+
+    /**
+     * @brief Strips the prerelease component, reusing the storage of this
+     * instance.
+     */
+    version strip_prerelease() &&;
 
     /**
      * @brief Strips the metadata component.
      *
      * @return A semver::version object representing the modified version.
      */
-    version strip_metadata() const;
+    version strip_metadata() const &;
+
+    /**
+     * @brief Strips the metadata component, reusing the storage of this
+     * instance.
+     */
+    version strip_metadata() &&;
 
     /**
      * @brief Checks whether the instance is a release version.
@@ -269,6 +631,34 @@ namespace semver
      */
     bool operator>(const version& rh) const;
   };
+
+  template<typename OutputIt>
+  OutputIt version::format_to(OutputIt out) const
+  {
+    out = std::copy(versions[0].begin(), versions[0].end(), out);
+
+    for (size_t i = 1; i < versions.size(); ++i)
+    {
+      *out++ = '.';
+      out = std::copy(versions[i].begin(), versions[i].end(), out);
+    }
+
+    if (!prerelease.empty())
+    {
+      std::string_view s = prerelease.view();
+      *out++ = '-';
+      out = std::copy(s.begin(), s.end(), out);
+    }
+
+    if (!metadata.empty())
+    {
+      std::string_view s = metadata.view();
+      *out++ = '+';
+      out = std::copy(s.begin(), s.end(), out);
+    }
+
+    return out;
+  }
 }
 
 #endif // SEMVER_UTILS_VERSION_H
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "version_arena.hpp"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  version_arena::version_arena(size_t initial_size) :
+    resource(initial_size)
+  {
+  }
+
+  version_arena::handle version_arena::parse(std::string_view v)
+  {
+    // The vector itself is allocated from the heap: when it grows, the
+    // versions are moved and keep their components in the arena.
+    versions.push_back(version::from_string(v, pool, &resource));
+
+    return versions.size() - 1;
+  }
+
+  void version_arena::reserve(size_t n)
+  {
+    versions.reserve(n);
+  }
+
+  const version& version_arena::operator[](handle h) const
+  {
+    return versions[h];
+  }
+
+  size_t version_arena::size() const
+  {
+    return versions.size();
+  }
+
+  bool version_arena::empty() const
+  {
+    return versions.empty();
+  }
+
+  void version_arena::release()
+  {
+    versions.clear();
+    pool.clear();
+    resource.release();
+  }
+}
+
+#pragma clang diagnostic pop
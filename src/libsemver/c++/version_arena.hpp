@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the semver::version_arena class.
+ *
+ * This header defines the semver::version_arena class, which parses batches of
+ * versions into a single memory arena.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_VERSION_ARENA_H
+#define SEMVER_UTILS_VERSION_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+#include "intern_pool.hpp"
+#include "version.hpp"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief Batch of versions allocated from a single memory arena.
+   *
+   * The components of the versions parsed by an arena are allocated from a
+   * `std::pmr::monotonic_buffer_resource` that grows by large blocks, instead
+   * of with several small heap allocations per version, and their prerelease
+   * and metadata strings are interned into a semver::intern_pool owned by the
+   * arena.  Versions are referred to by handles, their positions in the
+   * batch, and are all released at once by release() or when the arena is
+   * destroyed.
+   *
+   * Versions copied out of an arena own their strings and can outlive it.
+   */
+  class version_arena
+  {
+  public:
+    /**
+     * @brief The type of the handles of the versions of an arena.
+     */
+    using handle = size_t;
+
+    /**
+     * @brief Constructs an empty arena.
+     *
+     * @param initial_size The size of the first block of memory of the arena.
+     */
+    explicit version_arena(size_t initial_size = 4096);
+
+    version_arena(const version_arena&) = delete;
+    version_arena& operator=(const version_arena&) = delete;
+
+    /**
+     * @brief Parses @p v and adds it to the arena.
+     *
+     * @param v The version number to parse.
+     * @return The handle of the version.
+     * @throws std::invalid_argument if @p v is not a valid version number.
+     */
+    handle parse(std::string_view v);
+
+    /**
+     * @brief Reserves room for the handles of @p n versions.
+     */
+    void reserve(size_t n);
+
+    /**
+     * @brief Gets the version referred to by @p h.
+     *
+     * The reference is valid until the next version is added or the arena is
+     * released.
+     */
+    const version& operator[](handle h) const;
+
+    /**
+     * @brief Gets the number of versions of the arena.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether the arena is empty.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Destroys all the versions of the arena and releases its memory,
+     * including its interned strings.
+     *
+     * All handles are invalidated.
+     */
+    void release();
+
+  private:
+    // Declared first so that the versions are destroyed before their memory
+    // is released.
+    std::pmr::monotonic_buffer_resource resource;
+    intern_pool pool;
+    std::vector<version> versions;
+  };
+}
+
+#endif // SEMVER_UTILS_VERSION_ARENA_H
+
+#pragma clang diagnostic pop
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "version_batch.hpp"
+#include <algorithm>
+#include <limits>
+#include <string>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  include <immintrin.h>
+#  define SEMVER_BATCH_AVX2
+#endif
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  // Gets the components of v as integers, if it has three components that fit
+  // in 64 bits.
+  static bool to_key(const version& v, uint64_t key[3])
+  {
+    if (v.get_version_count() != 3) return false;
+
+    const uint64_t max = std::numeric_limits<uint64_t>::max();
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      uint64_t value = 0;
+
+      for (char c : v.get_version_view(i))
+      {
+        uint64_t digit = static_cast<uint64_t>(c - '0');
+
+        if (digit > 9 || value > (max - digit) / 10) return false;
+        value = value * 10 + digit;
+      }
+
+      key[i] = value;
+    }
+
+    return true;
+  }
+
+  // Gets the position of the lowest bit set in bits, which is not 0.
+  static unsigned int lowest_bit(uint64_t bits)
+  {
+#ifdef __GNUC__
+    return static_cast<unsigned int>(__builtin_ctzll(bits));
+#else
+    unsigned int i = 0;
+    while ((bits & 1) == 0)
+    {
+      bits >>= 1;
+      ++i;
+    }
+
+    return i;
+#endif
+  }
+
+  // Compares the n <= 64 keys of a block with key.  Bit i of greater is set if
+  // key i is greater than key, and bit i of equal if they are equal.
+  static void compare_block(const uint64_t *majors,
+                            const uint64_t *minors,
+                            const uint64_t *patches,
+                            size_t n,
+                            const uint64_t key[3],
+                            uint64_t& greater,
+                            uint64_t& equal)
+  {
+    greater = 0;
+    equal = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      bool eq_major = majors[i] == key[0];
+      bool eq_minor = minors[i] == key[1];
+      bool gt = (majors[i] > key[0])
+                | (eq_major & ((minors[i] > key[1])
+                               | (eq_minor & (patches[i] > key[2]))));
+
+      greater |= static_cast<uint64_t>(gt) << i;
+      equal |= static_cast<uint64_t>(eq_major & eq_minor
+                                     & (patches[i] == key[2])) << i;
+    }
+  }
+
+#ifdef SEMVER_BATCH_AVX2
+  // AVX2 only compares signed 64-bit integers: flipping the sign bit of both
+  // operands turns an unsigned comparison into a signed one.
+  __attribute__((target("avx2")))
+  static void compare_block_avx2(const uint64_t *majors,
+                                 const uint64_t *minors,
+                                 const uint64_t *patches,
+                                 size_t n,
+                                 const uint64_t key[3],
+                                 uint64_t& greater,
+                                 uint64_t& equal)
+  {
+    const __m256i sign = _mm256_set1_epi64x(
+      static_cast<long long>(uint64_t(1) << 63));
+    const __m256i key_major = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<long long>(key[0])), sign);
+    const __m256i key_minor = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<long long>(key[1])), sign);
+    const __m256i key_patch = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<long long>(key[2])), sign);
+
+    size_t i = 0;
+    greater = 0;
+    equal = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+      __m256i major = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(majors + i)),
+        sign);
+      __m256i minor = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(minors + i)),
+        sign);
+      __m256i patch = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(patches + i)),
+        sign);
+
+      __m256i eq_major = _mm256_cmpeq_epi64(major, key_major);
+      __m256i eq_minor = _mm256_cmpeq_epi64(minor, key_minor);
+      __m256i gt = _mm256_or_si256(
+        _mm256_cmpgt_epi64(major, key_major),
+        _mm256_and_si256(
+          eq_major,
+          _mm256_or_si256(
+            _mm256_cmpgt_epi64(minor, key_minor),
+            _mm256_and_si256(eq_minor,
+                             _mm256_cmpgt_epi64(patch, key_patch)))));
+      __m256i eq = _mm256_and_si256(
+        _mm256_and_si256(eq_major, eq_minor),
+        _mm256_cmpeq_epi64(patch, key_patch));
+
+      greater |= static_cast<uint64_t>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(gt))) << i;
+      equal |= static_cast<uint64_t>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(eq))) << i;
+    }
+
+    if (i < n)
+    {
+      uint64_t tail_greater;
+      uint64_t tail_equal;
+
+      compare_block(majors + i, minors + i, patches + i, n - i, key,
+                    tail_greater, tail_equal);
+
+      greater |= tail_greater << i;
+      equal |= tail_equal << i;
+    }
+  }
+#endif
+
+  void version_batch::push_back(const version& v)
+  {
+    uint64_t key[3] = {0, 0, 0};
+    bool regular = to_key(v, key);
+
+    if (count % 64 == 0)
+    {
+      irregular.push_back(0);
+      prereleases.push_back(0);
+    }
+
+    const uint64_t bit = uint64_t(1) << (count % 64);
+
+    if (!regular) irregular.back() |= bit;
+    if (!v.is_release()) prereleases.back() |= bit;
+
+    if (!regular || !v.is_release() || !v.get_metadata_view().empty())
+      originals.emplace(count, v);
+
+    majors.push_back(key[0]);
+    minors.push_back(key[1]);
+    patches.push_back(key[2]);
+    ++count;
+  }
+
+  size_t version_batch::size() const
+  {
+    return count;
+  }
+
+  bool version_batch::empty() const
+  {
+    return count == 0;
+  }
+
+  version version_batch::operator[](size_t i) const
+  {
+    auto it = originals.find(i);
+    if (it != originals.end()) return it->second;
+
+    return version(std::vector<std::string>{std::to_string(majors[i]),
+                                            std::to_string(minors[i]),
+                                            std::to_string(patches[i])},
+                   "",
+                   "");
+  }
+
+  bool version_batch::is_greater(size_t i, const version& v) const
+  {
+    auto it = originals.find(i);
+    if (it != originals.end()) return it->second > v;
+
+    return (*this)[i] > v;
+  }
+
+  std::vector<uint64_t> version_batch::greater_mask(const version& v) const
+  {
+    std::vector<uint64_t> mask((count + 63) / 64, 0);
+    uint64_t key[3];
+
+    if (!to_key(v, key))
+    {
+      for (size_t i = 0; i < count; ++i)
+        if (is_greater(i, v)) mask[i / 64] |= uint64_t(1) << (i % 64);
+
+      return mask;
+    }
+
+#ifdef SEMVER_BATCH_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+    for (size_t w = 0; w < mask.size(); ++w)
+    {
+      size_t first = w * 64;
+      size_t n = std::min<size_t>(64, count - first);
+      uint64_t greater;
+      uint64_t equal;
+
+#ifdef SEMVER_BATCH_AVX2
+      if (has_avx2)
+        compare_block_avx2(majors.data() + first,
+                           minors.data() + first,
+                           patches.data() + first,
+                           n, key, greater, equal);
+      else
+#endif
+        compare_block(majors.data() + first,
+                      minors.data() + first,
+                      patches.data() + first,
+                      n, key, greater, equal);
+
+      // Equal components decide nothing if either version has a prerelease.
+      uint64_t slow = irregular[w]
+                      | (equal & (v.is_release() ? prereleases[w] : ~0ULL));
+      greater &= ~slow;
+
+      for (; slow != 0; slow &= slow - 1)
+      {
+        size_t i = first + lowest_bit(slow);
+
+        if (is_greater(i, v)) greater |= uint64_t(1) << (i % 64);
+      }
+
+      mask[w] = greater;
+    }
+
+    return mask;
+  }
+
+  std::vector<size_t> version_batch::greater_than(const version& v) const
+  {
+    std::vector<size_t> indices;
+    std::vector<uint64_t> mask = greater_mask(v);
+
+    for (size_t w = 0; w < mask.size(); ++w)
+      for (uint64_t bits = mask[w]; bits != 0; bits &= bits - 1)
+        indices.push_back(w * 64 + lowest_bit(bits));
+
+    return indices;
+  }
+}
+
+#pragma clang diagnostic pop
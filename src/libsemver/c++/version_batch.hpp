@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the semver::version_batch class.
+ *
+ * This header defines the semver::version_batch class, an array of versions
+ * that can be compared with a version in bulk.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_VERSION_BATCH_H
+#define SEMVER_UTILS_VERSION_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "version.hpp"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief Array of versions optimized for comparisons with a single version.
+   *
+   * The major, minor and patch components of the versions are stored in three
+   * columns of 64-bit integers, so that a query such as "which versions are
+   * newer than X" compares many versions at once: 4 per instruction with AVX2
+   * when the CPU supports it, and in a branch-free loop otherwise.  Only the
+   * versions whose components are equal to X's are compared again, one by
+   * one, when either has a prerelease.
+   *
+   * Versions that the columns cannot represent, because they do not have
+   * three components or because a component does not fit in 64 bits, are
+   * always compared one by one.  Versions with a prerelease or metadata are
+   * kept as semver::version objects besides the columns.
+   *
+   * Unlike semver::columnar_set, a batch is not sorted: versions keep the
+   * position they were added at, and results refer to those positions.
+   */
+  class version_batch
+  {
+  public:
+    /**
+     * @brief Constructs an empty batch.
+     */
+    version_batch() = default;
+
+    /**
+     * @brief Appends @p v to the batch.
+     *
+     * @param v The version to append.
+     */
+    void push_back(const version& v);
+
+    /**
+     * @brief Gets the number of versions of the batch.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether the batch is empty.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Gets the version at position @p i.
+     */
+    version operator[](size_t i) const;
+
+    /**
+     * @brief Compares every version of the batch with @p v.
+     *
+     * @param v The version to compare with.
+     * @return A bit mask whose bit `i % 64` of word `i / 64` is set if the
+     * version at position `i` has higher precedence than @p v.
+     */
+    std::vector<uint64_t> greater_mask(const version& v) const;
+
+    /**
+     * @brief Finds the versions of the batch with higher precedence than
+     * @p v.
+     *
+     * @param v The version to compare with.
+     * @return The positions of the versions, in ascending order.
+     */
+    std::vector<size_t> greater_than(const version& v) const;
+
+  private:
+    bool is_greater(size_t i, const version& v) const;
+
+    std::vector<uint64_t> majors;
+    std::vector<uint64_t> minors;
+    std::vector<uint64_t> patches;
+    // Bit masks of the versions that are always compared one by one, and of
+    // the versions with a prerelease.
+    std::vector<uint64_t> irregular;
+    std::vector<uint64_t> prereleases;
+    // Versions that the columns do not represent entirely.
+    std::unordered_map<size_t, version> originals;
+    size_t count = 0;
+  };
+}
+
+#endif // SEMVER_UTILS_VERSION_BATCH_H
+
+#pragma clang diagnostic pop
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "version_literal.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "../gettext_defs.h"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  void invalid_version_literal(std::string_view s)
+  {
+    throw std::invalid_argument(_("Invalid version: ") + std::string(s));
+  }
+
+  version version_literal::to_version() const
+  {
+    return version(numbers[0], numbers[1], numbers[2], pre, meta);
+  }
+
+  // Compares two numbers without leading zeroes: the longer one is greater.
+  static int compare_number(std::string_view lh, std::string_view rh)
+  {
+    if (lh.size() != rh.size()) return lh.size() < rh.size() ? -1 : 1;
+
+    return lh.compare(rh);
+  }
+
+  // Gets the next identifier of prerelease starting at pos.
+  static prerelease_token next_identifier(std::string_view prerelease,
+                                              size_t& pos)
+  {
+    size_t begin = pos;
+    size_t end = std::min(prerelease.find('.', begin), prerelease.size());
+    pos = end + 1;
+
+    return prerelease_token(prerelease, begin, end - begin);
+  }
+
+  int compare(const version& lh, const version_literal& rh)
+  {
+    size_t common = std::min(lh.get_version_count(), rh.size());
+
+    for (size_t i = 0; i < common; ++i)
+    {
+      int c = compare_number(lh.get_version_view(i), rh.component(i));
+      if (c != 0) return c;
+    }
+
+    if (lh.get_version_count() != rh.size())
+      return lh.get_version_count() < rh.size() ? -1 : 1;
+
+    std::string_view lp = lh.get_prerelease_view();
+    std::string_view rp = rh.prerelease();
+
+    if (lp.empty() || rp.empty()) return lp.empty() - rp.empty();
+
+    size_t lpos = 0;
+    size_t rpos = 0;
+
+    while (lpos < lp.size() && rpos < rp.size())
+    {
+      int c = prerelease_token::compare(next_identifier(lp, lpos), lp,
+                                        next_identifier(rp, rpos), rp);
+      if (c != 0) return c;
+    }
+
+    if (lpos < lp.size()) return 1;
+    if (rpos < rp.size()) return -1;
+
+    return 0;
+  }
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the semver::version_literal class.
+ *
+ * This header defines the semver::version_literal class, a version parsed and
+ * validated at compile time, and the `_semver` user-defined literal.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_VERSION_LITERAL_H
+#define SEMVER_UTILS_VERSION_LITERAL_H
+
+#include <cstddef>
+#include <string_view>
+#include "version.hpp"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief Reports an invalid version literal.
+   *
+   * This function is not `constexpr`: reaching it while a literal is parsed
+   * during constant evaluation makes the program ill-formed.
+   *
+   * @throws std::invalid_argument always.
+   */
+  [[noreturn]] void invalid_version_literal(std::string_view s);
+
+  /**
+   * @brief Class that represents a version known at compile time.
+   *
+   * A version_literal is parsed and validated by a `constexpr` constructor,
+   * so that a constant such as
+   *
+   *     constexpr auto minimum = "2.0.0-rc.1"_semver;
+   *
+   * has no initialization cost and an invalid literal is a compile error.
+   * Only the literals evaluated as constants are rejected at compile time:
+   * an invalid literal initializing a variable that is not `constexpr`, such
+   * as `auto v = "1.2"_semver;`, compiles and throws std::invalid_argument
+   * when it is evaluated.
+   *
+   * A literal has exactly three numeric components of any number of digits,
+   * as with semver::version::from_string().  The components, the prerelease
+   * and the metadata are views of the parsed string, which must outlive the
+   * instance: string literals always do.
+   *
+   * Instances can be compared with semver::version objects, using the same
+   * rules as semver::version::operator==() and semver::version::operator<().
+   */
+  class version_literal
+  {
+  public:
+    /**
+     * @brief Number of numeric components of a literal.
+     */
+    static constexpr size_t COMPONENTS = 3;
+
+    /**
+     * @brief Parses @p s.
+     *
+     * @param s The version string.
+     * @throws std::invalid_argument if @p s does not comply with _Semantic
+     * Versioning 2.0.0_.  During constant evaluation, an invalid @p s is a
+     * compile error.
+     */
+    constexpr explicit version_literal(std::string_view s) :
+      text(s)
+    {
+      size_t pos = 0;
+
+      for (size_t i = 0; i < COMPONENTS; ++i)
+      {
+        if (i > 0)
+        {
+          if (pos == s.size() || s[pos] != '.') invalid_version_literal(s);
+          ++pos;
+        }
+
+        numbers[i] = parse_number(s, pos);
+      }
+
+      if (pos < s.size() && s[pos] == '-')
+      {
+        size_t begin = ++pos;
+        pos = scan_identifiers(s, pos, true);
+        pre = s.substr(begin, pos - begin);
+      }
+
+      if (pos < s.size() && s[pos] == '+')
+      {
+        size_t begin = ++pos;
+        pos = scan_identifiers(s, pos, false);
+        meta = s.substr(begin, pos - begin);
+      }
+
+      if (pos != s.size()) invalid_version_literal(s);
+    }
+
+    /**
+     * @brief Gets the number of numeric components, always
+     * semver::version_literal::COMPONENTS.
+     */
+    constexpr size_t size() const
+    {
+      return COMPONENTS;
+    }
+
+    /**
+     * @brief Gets the digits of the numeric component @p index, or `"0"` if
+     * the literal has no such component.
+     */
+    constexpr std::string_view component(size_t index) const
+    {
+      return index < COMPONENTS ? numbers[index] : std::string_view("0");
+    }
+
+    /**
+     * @brief Gets the prerelease string.
+     */
+    constexpr std::string_view prerelease() const
+    {
+      return pre;
+    }
+
+    /**
+     * @brief Gets the metadata string.
+     */
+    constexpr std::string_view metadata() const
+    {
+      return meta;
+    }
+
+    /**
+     * @brief Gets the string the literal was parsed from.
+     */
+    constexpr std::string_view str() const
+    {
+      return text;
+    }
+
+    /**
+     * @brief Checks whether this literal is a release version.
+     */
+    constexpr bool is_release() const
+    {
+      return pre.empty();
+    }
+
+    /**
+     * @brief Converts this literal to a semver::version.
+     */
+    version to_version() const;
+
+  private:
+    std::string_view text;
+    std::string_view pre;
+    std::string_view meta;
+    std::string_view numbers[COMPONENTS];
+
+    static constexpr bool is_digit(char c)
+    {
+      return c >= '0' && c <= '9';
+    }
+
+    static constexpr bool is_identifier_char(char c)
+    {
+      return is_digit(c)
+             || (c >= 'a' && c <= 'z')
+             || (c >= 'A' && c <= 'Z')
+             || c == '-';
+    }
+
+    // Scans a number without leading zeroes starting at pos.
+    static constexpr std::string_view parse_number(std::string_view s,
+                                                   size_t& pos)
+    {
+      size_t begin = pos;
+
+      while (pos < s.size() && is_digit(s[pos])) ++pos;
+
+      if (pos == begin || (s[begin] == '0' && pos - begin > 1))
+        invalid_version_literal(s);
+
+      return s.substr(begin, pos - begin);
+    }
+
+    // Scans dot-separated identifiers starting at pos and returns the position
+    // past the last one.  Numeric prerelease identifiers cannot have leading
+    // zeroes.
+    static constexpr size_t scan_identifiers(std::string_view s,
+                                             size_t pos,
+                                             bool prerelease)
+    {
+      for (;;)
+      {
+        size_t begin = pos;
+        bool numeric = true;
+
+        for (; pos < s.size() && is_identifier_char(s[pos]); ++pos)
+          if (!is_digit(s[pos])) numeric = false;
+
+        if (pos == begin) invalid_version_literal(s);
+
+        if (prerelease && numeric && s[begin] == '0' && pos - begin > 1)
+          invalid_version_literal(s);
+
+        if (pos == s.size() || s[pos] != '.') return pos;
+        ++pos;
+      }
+    }
+  };
+
+  /**
+   * @brief Compares a version with a literal.
+   *
+   * @return A negative number, zero or a positive number if @p lh has lower,
+   * equal or higher precedence than @p rh, respectively.  Metadata is ignored.
+   */
+  int compare(const version& lh, const version_literal& rh);
+
+  inline bool operator==(const version& lh, const version_literal& rh)
+  {
+    return compare(lh, rh) == 0;
+  }
+
+  inline bool operator!=(const version& lh, const version_literal& rh)
+  {
+    return compare(lh, rh) != 0;
+  }
+
+  inline bool operator<(const version& lh, const version_literal& rh)
+  {
+    return compare(lh, rh) < 0;
+  }
+
+  inline bool operator<=(const version& lh, const version_literal& rh)
+  {
+    return compare(lh, rh) <= 0;
+  }
+
+  inline bool operator>(const version& lh, const version_literal& rh)
+  {
+    return compare(lh, rh) > 0;
+  }
+
+  inline bool operator>=(const version& lh, const version_literal& rh)
+  {
+    return compare(lh, rh) >= 0;
+  }
+
+  inline bool operator==(const version_literal& lh, const version& rh)
+  {
+    return compare(rh, lh) == 0;
+  }
+
+  inline bool operator!=(const version_literal& lh, const version& rh)
+  {
+    return compare(rh, lh) != 0;
+  }
+
+  inline bool operator<(const version_literal& lh, const version& rh)
+  {
+    return compare(rh, lh) > 0;
+  }
+
+  inline bool operator<=(const version_literal& lh, const version& rh)
+  {
+    return compare(rh, lh) >= 0;
+  }
+
+  inline bool operator>(const version_literal& lh, const version& rh)
+  {
+    return compare(rh, lh) < 0;
+  }
+
+  inline bool operator>=(const version_literal& lh, const version& rh)
+  {
+    return compare(rh, lh) <= 0;
+  }
+
+  /**
+   * @brief Namespace of the user-defined literals of `libsemver`.
+   */
+  namespace literals
+  {
+    /**
+     * @brief Parses a version literal, such as `"1.2.3"_semver`.
+     */
+    constexpr version_literal operator""_semver(const char *s, size_t size)
+    {
+      return version_literal(std::string_view(s, size));
+    }
+  }
+}
+
+#endif // SEMVER_UTILS_VERSION_LITERAL_H
+
+#pragma clang diagnostic pop
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "version_reader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <istream>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include "../gettext_defs.h"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  static bool is_separator(char c)
+  {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f'
+           || c == '\r';
+  }
+
+  version_reader::version_reader(read_function read, size_t chunk_size) :
+    read(std::move(read)),
+    buffer(chunk_size > 0 ? chunk_size : DEFAULT_CHUNK_SIZE)
+  {
+  }
+
+  version_reader::version_reader(std::istream& in, size_t chunk_size) :
+    version_reader(
+      [&in](char *buf, size_t size)
+      {
+        // Only the characters already available are taken, so that the
+        // tokens received so far are yielded before the stream blocks again.
+        // When none are, the reader waits for the next one.
+        std::streambuf *sb = in.rdbuf();
+        std::streamsize avail = sb ? sb->in_avail() : -1;
+
+        if (avail == 0)
+        {
+          if (sb->sgetc() == std::char_traits<char>::eof()) avail = -1;
+          else avail = std::max<std::streamsize>(sb->in_avail(), 1);
+        }
+
+        if (avail < 0)
+        {
+          in.setstate(std::ios_base::eofbit);
+          return size_t(0);
+        }
+
+        avail = std::min(avail, static_cast<std::streamsize>(size));
+
+        return static_cast<size_t>(sb->sgetn(buf, avail));
+      },
+      chunk_size)
+  {
+  }
+
+  version_reader::version_reader(int fd, size_t chunk_size) :
+    version_reader(
+      [fd](char *buf, size_t size)
+      {
+        for (;;)
+        {
+          ssize_t n = ::read(fd, buf, size);
+
+          if (n >= 0) return static_cast<size_t>(n);
+          if (errno != EINTR)
+            throw std::system_error(errno, std::generic_category());
+        }
+      },
+      chunk_size)
+  {
+  }
+
+  bool version_reader::fill()
+  {
+    pos = 0;
+    end_pos = read(buffer.data(), buffer.size());
+
+    return end_pos > 0;
+  }
+
+  bool version_reader::next_token(std::string_view& token)
+  {
+    for (;;)
+    {
+      while (pos < end_pos && is_separator(buffer[pos])) ++pos;
+
+      if (pos < end_pos) break;
+      if (!fill()) return false;
+    }
+
+    size_t begin = pos;
+    while (pos < end_pos && !is_separator(buffer[pos])) ++pos;
+
+    // Most tokens end within the chunk they start in and are views of it:
+    // only the tokens split across chunks are assembled in partial.
+    if (pos < end_pos)
+    {
+      token = std::string_view(buffer.data() + begin, pos - begin);
+      return true;
+    }
+
+    partial.assign(buffer.data() + begin, pos - begin);
+
+    while (fill())
+    {
+      while (pos < end_pos && !is_separator(buffer[pos])) ++pos;
+
+      partial.append(buffer.data(), pos);
+
+      if (pos < end_pos) break;
+    }
+
+    token = partial;
+
+    return true;
+  }
+
+  bool version_reader::next(parsed_version& out)
+  {
+    std::string_view token;
+
+    if (!next_token(token)) return false;
+
+    // The token is copied, since the chunk it is a view of is overwritten by
+    // the next read.  Each token is parsed once, and invalid tokens are
+    // rejected without building an exception.
+    out.token.assign(token);
+    out.error.clear();
+    out.value = version::try_from_string(token);
+
+    if (!out.ok()) out.error.append(_("Invalid version: ")).append(token);
+
+    return true;
+  }
+
+  version_reader::iterator version_reader::begin()
+  {
+    return iterator(this);
+  }
+
+  version_reader::iterator version_reader::end()
+  {
+    return iterator();
+  }
+
+  version_reader::iterator::iterator(version_reader *reader) :
+    reader(reader)
+  {
+    ++*this;
+  }
+
+  version_reader::iterator::reference
+  version_reader::iterator::operator*() const
+  {
+    return current;
+  }
+
+  version_reader::iterator::pointer version_reader::iterator::operator->() const
+  {
+    return &current;
+  }
+
+  version_reader::iterator& version_reader::iterator::operator++()
+  {
+    if (!reader->next(current)) reader = nullptr;
+
+    return *this;
+  }
+
+  void version_reader::iterator::operator++(int)
+  {
+    ++*this;
+  }
+
+  bool version_reader::iterator::operator==(const iterator& other) const
+  {
+    return reader == other.reader;
+  }
+
+  bool version_reader::iterator::operator!=(const iterator& other) const
+  {
+    return !(*this == other);
+  }
+}
+
+#pragma clang diagnostic pop
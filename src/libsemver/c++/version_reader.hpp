@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Header of the semver::version_reader class.
+ *
+ * This header defines the semver::version_reader class, which parses the
+ * versions read from a stream incrementally.
+ *
+ * @copyright Copyright (c) 2016-2024 Enrico M. Crisostomo
+ * @license GNU General Public License v. 3.0
+ * @author Enrico M. Crisostomo
+ * @version 3.0.0
+ */
+#ifndef SEMVER_UTILS_VERSION_READER_H
+#define SEMVER_UTILS_VERSION_READER_H
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "version.hpp"
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
+
+namespace semver
+{
+  /**
+   * @brief A token read by a semver::version_reader and the result of its
+   * parsing.
+   */
+  struct parsed_version
+  {
+    /**
+     * @brief The token, as read from the input.
+     */
+    std::string token;
+
+    /**
+     * @brief The version, if the token is a valid version number.
+     */
+    std::optional<version> value;
+
+    /**
+     * @brief The reason why the token is not a valid version number.
+     */
+    std::string error;
+
+    /**
+     * @brief Checks whether the token is a valid version number.
+     */
+    bool ok() const
+    {
+      return value.has_value();
+    }
+  };
+
+  /**
+   * @brief Class that parses the versions read from an input source.
+   *
+   * The input is a sequence of tokens separated by whitespace, read by chunks
+   * of at most a fixed size: tokens are parsed one at a time, as they are
+   * pulled with next() or through an input iterator, and the whole input is
+   * never held in memory.  Invalid tokens do not stop the reader: they are
+   * returned with the reason they were rejected.
+   *
+   * The input source can be a `std::istream`, a file descriptor, or a
+   * function that fills a buffer and returns the number of bytes written
+   * into it, 0 at the end of the input.
+   */
+  class version_reader
+  {
+  public:
+    /**
+     * @brief The type of the functions that read the input.
+     */
+    using read_function = std::function<size_t(char *, size_t)>;
+
+    /**
+     * @brief The default size of the chunks of input read at a time.
+     */
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 16;
+
+    /**
+     * @brief Input iterator over the tokens of a reader.
+     */
+    class iterator
+    {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = parsed_version;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const parsed_version *;
+      using reference = const parsed_version&;
+
+      /**
+       * @brief Constructs the end iterator.
+       */
+      iterator() = default;
+
+      reference operator*() const;
+      pointer operator->() const;
+      iterator& operator++();
+      void operator++(int);
+      bool operator==(const iterator& other) const;
+      bool operator!=(const iterator& other) const;
+
+    private:
+      friend class version_reader;
+
+      explicit iterator(version_reader *reader);
+
+      version_reader *reader = nullptr;
+      parsed_version current;
+    };
+
+    /**
+     * @brief Constructs a reader of the input returned by @p read.
+     *
+     * @param read The function reading the input.
+     * @param chunk_size The number of bytes read at a time.
+     */
+    explicit version_reader(read_function read,
+                            size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief Constructs a reader of @p in, which must outlive the reader.
+     *
+     * Each read takes the characters already buffered by @p in, and waits for
+     * the next one only when there are none: a token is yielded as soon as it
+     * has arrived, even if the stream then blocks.
+     *
+     * @param in The input stream.
+     * @param chunk_size The number of bytes read at a time.
+     */
+    explicit version_reader(std::istream& in,
+                            size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief Constructs a reader of the file descriptor @p fd, which is not
+     * closed.
+     *
+     * @param fd The file descriptor.
+     * @param chunk_size The number of bytes read at a time.
+     * @throws std::system_error from next() if @p fd cannot be read.
+     */
+    explicit version_reader(int fd, size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+    version_reader(const version_reader&) = delete;
+    version_reader& operator=(const version_reader&) = delete;
+
+    /**
+     * @brief Reads and parses the next token.
+     *
+     * @param out The object the result is stored into.  The token is copied
+     * into it, reusing the capacity of its strings across calls.
+     * @return `true` if a token was read, `false` at the end of the input.
+     */
+    bool next(parsed_version& out);
+
+    /**
+     * @brief Gets an iterator to the next token.
+     *
+     * The tokens are consumed as the iterator is incremented: a reader can be
+     * iterated only once.
+     */
+    iterator begin();
+
+    /**
+     * @brief Gets the end iterator.
+     */
+    iterator end();
+
+  private:
+    read_function read;
+    std::vector<char> buffer;
+    size_t pos = 0;
+    size_t end_pos = 0;
+    // A token split across chunks.
+    std::string partial;
+
+    bool fill();
+    bool next_token(std::string_view& token);
+  };
+}
+
+#endif // SEMVER_UTILS_VERSION_READER_H
+
+#pragma clang diagnostic pop
@@ -24,6 +24,7 @@
 
 #include "libsemver.h"
 #include "errors.h"
+#include "../c++/validation.hpp"
 #include "../c++/version.hpp"
 #include "../gettext_defs.h"
 #include <exception>
@@ -119,6 +120,13 @@ void semver_free(semver_t *ver)
   delete ver;
 }
 
+bool semver_is_valid(const char *str)
+{
+  semver_reset_last_error();
+
+  return semver::is_valid(str);
+}
+
 const char *semver_str(semver_t *ver)
 {
   semver_reset_last_error();
@@ -126,14 +134,14 @@ const char *semver_str(semver_t *ver)
   try
   {
     semver::version *version = static_cast<semver::version *>(ver->ptr);
-    std::string str = version->str();
+    size_t size = version->formatted_size();
 
-    char *c_str = (char *) malloc(sizeof(char) * (str.size() + 1));
+    char *c_str = (char *) malloc(sizeof(char) * (size + 1));
 
     if (!c_str) throw std::bad_alloc();
 
-    std::copy(str.begin(), str.end(), c_str);
-    c_str[str.size()] = '\0';
+    version->write(c_str, size);
+    c_str[size] = '\0';
 
     return c_str;
   }
@@ -164,9 +172,7 @@ const char * const *semver_get_versions(semver_t *ver)
   try
   {
     auto version = static_cast<semver::version *>(ver->ptr);
-    std::vector<std::string> versions = version->get_version();
-
-    auto c_vers = copy_vector_to_c_array(versions);
+    auto c_vers = copy_vector_to_c_array(version->get_version());
 
     return c_vers;
   }
@@ -185,10 +191,11 @@ const char *semver_get_version(semver_t *ver, unsigned int index)
   {
     auto version = static_cast<semver::version *>(ver->ptr);
 
-    std::string version_str = version->get_version(index);
+    std::string_view version_str = version->get_version_view(index);
     char *c_str = (char *)malloc(sizeof(char) * (version_str.size() + 1));
     if (!c_str) throw std::bad_alloc();
-    std::strcpy(c_str, version_str.c_str());
+    std::copy(version_str.begin(), version_str.end(), c_str);
+    c_str[version_str.size()] = '\0';
     return c_str;
   }
   catch (std::bad_alloc& ex)
@@ -205,7 +212,7 @@ const char *semver_get_prerelease(semver_t *ver)
   try
   {
     semver::version *version = static_cast<semver::version *>(ver->ptr);
-    std::string prerelease = version->get_prerelease();
+    std::string_view prerelease = version->get_prerelease_view();
 
     char *c_str = (char *) malloc(sizeof(char) * (prerelease.size() + 1));
 
@@ -231,7 +238,7 @@ const char *semver_get_metadata(semver_t *ver)
   {
     semver::version *version = static_cast<semver::version *>(ver->ptr);
 
-    std::string metadata = version->get_metadata();
+    std::string_view metadata = version->get_metadata_view();
 
     char *ptr_s = (char *) malloc(sizeof(char) * (metadata.size() + 1));
 
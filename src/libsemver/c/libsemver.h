@@ -51,6 +51,7 @@ semver_t *semver_create(const unsigned int *c_vers,
                         const char *prerelease,
                         const char *metadata);
 void semver_free(semver_t *ver);
+bool semver_is_valid(const char *str);
 
 const char *semver_str(semver_t *ver);
 const char * const *semver_get_versions(semver_t *ver);
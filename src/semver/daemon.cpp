@@ -0,0 +1,769 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "daemon.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <fcntl.h> // open()
+#include <poll.h> // poll()
+#include <sys/socket.h> // accept(), setsockopt(), shutdown()
+#include <sys/stat.h> // fstat()
+#include <sys/time.h> // timeval
+#include <unistd.h> // close(), pipe(), write()
+#include "libsemver/gettext_defs.h"
+#include "io.hpp"
+#include "protocol.hpp"
+
+namespace
+{
+  enum class relation
+  {
+    eq, ne, lt, le, gt, ge
+  };
+
+  struct constraint
+  {
+    relation op;
+    semver::version bound;
+  };
+
+  // Bounds of the range of versions satisfying a set of constraints.  A
+  // missing bound leaves the range open on that side.
+  struct range
+  {
+    const semver::version *low = nullptr;
+    bool low_inclusive = true;
+    const semver::version *high = nullptr;
+    bool high_inclusive = true;
+  };
+}
+
+std::shared_ptr<semver::concurrent_catalog>
+catalog_store::find(std::string_view name) const
+{
+  std::shared_ptr<const catalog_map> map = snapshot();
+  auto it = map->find(name);
+
+  return (it == map->end()) ? nullptr : it->second;
+}
+
+std::shared_ptr<const catalog_store::catalog_map>
+catalog_store::snapshot() const
+{
+  std::lock_guard<std::mutex> lock(catalogs_mutex);
+  return catalogs;
+}
+
+void catalog_store::publish(catalog_map map)
+{
+  auto s = std::make_shared<const catalog_map>(std::move(map));
+
+  std::lock_guard<std::mutex> lock(catalogs_mutex);
+  catalogs.swap(s);
+}
+
+void catalog_store::put(const std::string& name,
+                        std::vector<semver::version> versions)
+{
+  // The catalog is built before publishing it: readers are never blocked.
+  semver::catalog contents;
+  for (auto& v : versions) contents.insert(std::move(v));
+
+  std::lock_guard<std::mutex> lock(writer);
+
+  if (auto c = find(name))
+  {
+    c->publish(std::move(contents));
+    return;
+  }
+
+  catalog_map map = *catalogs;
+  map.emplace(
+    name,
+    std::make_shared<semver::concurrent_catalog>(std::move(contents)));
+  publish(std::move(map));
+}
+
+size_t catalog_store::add(const std::string& name,
+                          std::vector<semver::version> versions)
+{
+  std::shared_ptr<semver::concurrent_catalog> c;
+
+  {
+    std::lock_guard<std::mutex> lock(writer);
+    c = find(name);
+
+    if (!c)
+    {
+      c = std::make_shared<semver::concurrent_catalog>();
+
+      catalog_map map = *catalogs;
+      map.emplace(name, c);
+      publish(std::move(map));
+    }
+  }
+
+  return c->insert(std::move(versions));
+}
+
+size_t catalog_store::remove(std::string_view name,
+                             const std::vector<semver::version>& versions)
+{
+  std::shared_ptr<semver::concurrent_catalog> c = find(name);
+
+  if (!c)
+    throw std::invalid_argument(_("Unknown catalog: ") + std::string(name));
+
+  return c->erase(versions);
+}
+
+void catalog_store::read(
+  std::string_view name,
+  const std::function<void(const semver::catalog&)>& reader) const
+{
+  std::shared_ptr<semver::concurrent_catalog> c = find(name);
+
+  if (!c)
+    throw std::invalid_argument(_("Unknown catalog: ") + std::string(name));
+
+  semver::concurrent_catalog::snapshot s = c->get();
+  reader(*s);
+}
+
+bool catalog_store::erase(std::string_view name)
+{
+  std::lock_guard<std::mutex> lock(writer);
+  catalog_map map = *catalogs;
+  auto it = map.find(name);
+
+  if (it == map.end()) return false;
+
+  map.erase(it);
+  publish(std::move(map));
+
+  return true;
+}
+
+std::vector<std::string> catalog_store::names() const
+{
+  std::shared_ptr<const catalog_map> map = snapshot();
+  std::vector<std::string> result;
+  result.reserve(map->size());
+
+  for (const auto& entry : *map) result.push_back(entry.first);
+
+  return result;
+}
+
+// Parses the versions contained in tokens, starting from the one at index
+// first.
+static std::vector<semver::version>
+parse_versions(const std::vector<std::string_view>& tokens, size_t first)
+{
+  std::vector<semver::version> versions;
+  versions.reserve(tokens.size() - std::min(first, tokens.size()));
+
+  for (size_t i = first; i < tokens.size(); ++i)
+    versions.push_back(semver::version::from_string(tokens[i]));
+
+  return versions;
+}
+
+std::vector<semver::version> parse_catalog(std::string_view text)
+{
+  std::vector<std::string_view> tokens;
+  split_tokens(text, tokens);
+
+  return parse_versions(tokens, 0);
+}
+
+static constraint parse_constraint(std::string_view s)
+{
+  static const std::pair<std::string_view, relation> operators[] = {
+    {">=", relation::ge},
+    {"<=", relation::le},
+    {"!=", relation::ne},
+    {">",  relation::gt},
+    {"<",  relation::lt},
+    {"=",  relation::eq}
+  };
+
+  for (const auto& op : operators)
+  {
+    if (s.substr(0, op.first.size()) == op.first)
+      return {op.second,
+              semver::version::from_string(s.substr(op.first.size()))};
+  }
+
+  return {relation::eq, semver::version::from_string(s)};
+}
+
+static void restrict_low(range& r,
+                         const semver::version& bound,
+                         bool inclusive)
+{
+  if (r.low == nullptr
+      || *r.low < bound
+      || (*r.low == bound && !inclusive))
+  {
+    r.low = &bound;
+    r.low_inclusive = inclusive;
+  }
+}
+
+static void restrict_high(range& r,
+                          const semver::version& bound,
+                          bool inclusive)
+{
+  if (r.high == nullptr
+      || bound < *r.high
+      || (bound == *r.high && !inclusive))
+  {
+    r.high = &bound;
+    r.high_inclusive = inclusive;
+  }
+}
+
+// Finds the versions of c satisfying the order constraints with two lookups.
+// Inequality constraints are checked by excluded().
+static void narrow(const semver::catalog& c,
+                   const std::vector<constraint>& constraints,
+                   semver::catalog::const_iterator& first,
+                   semver::catalog::const_iterator& last)
+{
+  range r;
+
+  for (const auto& k : constraints)
+  {
+    switch (k.op)
+    {
+    case relation::eq:
+      restrict_low(r, k.bound, true);
+      restrict_high(r, k.bound, true);
+      break;
+
+    case relation::lt:
+      restrict_high(r, k.bound, false);
+      break;
+
+    case relation::le:
+      restrict_high(r, k.bound, true);
+      break;
+
+    case relation::gt:
+      restrict_low(r, k.bound, false);
+      break;
+
+    case relation::ge:
+      restrict_low(r, k.bound, true);
+      break;
+
+    case relation::ne:
+      break;
+    }
+  }
+
+  if (r.low != nullptr && r.high != nullptr
+      && (*r.high < *r.low
+          || (*r.low == *r.high && !(r.low_inclusive && r.high_inclusive))))
+  {
+    first = last = c.end();
+    return;
+  }
+
+  first = (r.low == nullptr) ? c.begin()
+          : r.low_inclusive ? c.lower_bound(*r.low) : c.upper_bound(*r.low);
+  last = (r.high == nullptr) ? c.end()
+         : r.high_inclusive ? c.upper_bound(*r.high) : c.lower_bound(*r.high);
+}
+
+static bool excluded(const semver::version& v,
+                     const std::vector<constraint>& constraints)
+{
+  return std::any_of(constraints.begin(),
+                     constraints.end(),
+                     [&v](const constraint& k)
+                     {
+                       return k.op == relation::ne && k.bound == v;
+                     });
+}
+
+static std::string_view catalog_name(std::string_view arg)
+{
+  if (arg.size() < 2 || arg[0] != '@')
+    throw std::invalid_argument(_("Invalid catalog: ") + std::string(arg));
+
+  return arg.substr(1);
+}
+
+static bool is_catalog_query(const std::vector<std::string_view>& args)
+{
+  if (args[0] == "satisfies" || args[0] == "latest") return true;
+  if (args[0] != "max" && args[0] != "min" && args[0] != "sort") return false;
+
+  return args.size() > 1 && !args[1].empty() && args[1][0] == '@';
+}
+
+static void query_catalog(const semver::catalog& c,
+                          const std::vector<std::string_view>& args,
+                          const std::vector<constraint>& constraints,
+                          std::string& response)
+{
+  const std::string_view command = args[0];
+
+  semver::catalog::const_iterator first;
+  semver::catalog::const_iterator last;
+  narrow(c, constraints, first, last);
+
+  if (command == "max")
+  {
+    while (last != first)
+    {
+      if (!excluded(*--last, constraints))
+      {
+        last->format_to(std::back_inserter(response));
+        return;
+      }
+    }
+  }
+  else if (command == "min")
+  {
+    for (; first != last; ++first)
+    {
+      if (!excluded(*first, constraints))
+      {
+        first->format_to(std::back_inserter(response));
+        return;
+      }
+    }
+  }
+  else
+  {
+    bool empty = true;
+
+    for (; first != last; ++first)
+    {
+      if (excluded(*first, constraints)) continue;
+
+      if (!empty) response += ' ';
+      first->format_to(std::back_inserter(response));
+      empty = false;
+    }
+
+    return;
+  }
+
+  throw std::invalid_argument(_("No version satisfies the constraints."));
+}
+
+static void query_catalog(const catalog_store& store,
+                          const std::vector<std::string_view>& args,
+                          std::string& response)
+{
+  const std::string_view command = args[0];
+
+  if (args.size() < 2
+      || (command == "satisfies" && args.size() < 3)
+      || (command == "latest" && args.size() != 3))
+    throw std::invalid_argument(_("Invalid number of arguments."));
+
+  std::string_view name = catalog_name(args[1]);
+
+  if (command == "latest")
+  {
+    unsigned long major;
+
+    const unsigned long max_major = std::numeric_limits<unsigned long>::max();
+
+    if (!parse_number(args[2], max_major, major))
+      throw std::invalid_argument(
+        _("Invalid version index: ") + std::string(args[2]));
+
+    store.read(name,
+               [&](const semver::catalog& c)
+               {
+                 std::optional<semver::version> v = c.latest_release(major);
+
+                 if (!v)
+                   throw std::invalid_argument(
+                     _("No version satisfies the constraints."));
+
+                 v->format_to(std::back_inserter(response));
+               });
+    return;
+  }
+
+  // Constraints are parsed before the catalog is locked.
+  std::vector<constraint> constraints;
+  for (size_t i = 2; i < args.size(); ++i)
+    constraints.push_back(parse_constraint(args[i]));
+
+  store.read(name,
+             [&](const semver::catalog& c)
+             {
+               query_catalog(c, args, constraints, response);
+             });
+}
+
+static std::vector<semver::version>
+load_catalog(const std::string& catalog_dir, std::string_view file)
+{
+  if (catalog_dir.empty())
+    throw std::invalid_argument(_("No catalog directory is configured."));
+
+  // Clients can only name the regular files of the catalog directory: paths
+  // and symbolic links could otherwise make the server read any file it can
+  // access.
+  if (file.empty() || file == "." || file == ".."
+      || file.find('/') != std::string_view::npos)
+    throw std::invalid_argument(
+      _("Invalid catalog file: ") + std::string(file));
+
+  std::string path = catalog_dir + '/' + std::string(file);
+  int fd;
+
+  do
+  {
+    fd = ::open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_NONBLOCK);
+  }
+  while (fd < 0 && errno == EINTR);
+
+  if (fd < 0)
+    throw std::invalid_argument(
+      std::string(file) + ": " + std::generic_category().message(errno));
+
+  try
+  {
+    struct stat st;
+
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+      throw std::invalid_argument(
+        _("Invalid catalog file: ") + std::string(file));
+
+    mapped_input input(fd);
+    std::vector<semver::version> versions = parse_catalog(input.data());
+    ::close(fd);
+
+    return versions;
+  }
+  catch (std::system_error& ex)
+  {
+    ::close(fd);
+    throw std::invalid_argument(std::string(file) + ": " + ex.what());
+  }
+  catch (...)
+  {
+    ::close(fd);
+    throw;
+  }
+}
+
+bool execute_catalog_request(catalog_store& store,
+                             const std::string& catalog_dir,
+                             const std::vector<std::string_view>& args,
+                             std::string& response)
+{
+  if (args.empty() || !(args[0] == "load"
+                        || args[0] == "define"
+                        || args[0] == "add"
+                        || args[0] == "remove"
+                        || args[0] == "drop"
+                        || args[0] == "catalogs"
+                        || is_catalog_query(args)))
+    return execute_request(args, response);
+
+  const std::string_view command = args[0];
+
+  if (command == "load")
+  {
+    if (args.size() != 3)
+      throw std::invalid_argument(_("Invalid number of arguments."));
+
+    std::vector<semver::version> versions = load_catalog(catalog_dir, args[2]);
+
+    response += std::to_string(versions.size());
+    store.put(std::string(args[1]), std::move(versions));
+  }
+  else if (command == "define" || command == "add" || command == "remove")
+  {
+    if (args.size() < 2)
+      throw std::invalid_argument(_("Invalid number of arguments."));
+
+    std::vector<semver::version> versions = parse_versions(args, 2);
+    size_t count = versions.size();
+
+    if (command == "define")
+      store.put(std::string(args[1]), std::move(versions));
+    else if (command == "add")
+      count = store.add(std::string(args[1]), std::move(versions));
+    else
+      count = store.remove(args[1], versions);
+
+    response += std::to_string(count);
+  }
+  else if (command == "drop")
+  {
+    if (args.size() != 2)
+      throw std::invalid_argument(_("Invalid number of arguments."));
+
+    if (!store.erase(args[1]))
+      throw std::invalid_argument(
+        _("Unknown catalog: ") + std::string(args[1]));
+
+    response += "ok";
+  }
+  else if (command == "catalogs")
+  {
+    std::vector<std::string> names = store.names();
+
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+      if (i > 0) response += ' ';
+      response += names[i];
+    }
+  }
+  else
+  {
+    query_catalog(store, args, response);
+  }
+
+  return true;
+}
+
+catalog_server::catalog_server(catalog_store& store,
+                               unsigned int threads,
+                               std::string catalog_dir,
+                               unsigned int idle_timeout) :
+  store(store),
+  threads(std::max(1u, threads)),
+  catalog_dir(std::move(catalog_dir)),
+  idle_timeout(idle_timeout)
+{
+  if (::pipe(wakeup) != 0)
+    throw std::system_error(errno, std::generic_category());
+
+  if (::pipe(released) != 0)
+  {
+    int error = errno;
+    ::close(wakeup[0]);
+    ::close(wakeup[1]);
+    throw std::system_error(error, std::generic_category());
+  }
+}
+
+catalog_server::~catalog_server()
+{
+  ::close(wakeup[0]);
+  ::close(wakeup[1]);
+  ::close(released[0]);
+  ::close(released[1]);
+}
+
+// Checks whether accept() failed for lack of resources, which other
+// connections may release.
+static bool is_transient_accept_error(int error)
+{
+  return error == EMFILE || error == ENFILE || error == ENOBUFS
+         || error == ENOMEM;
+}
+
+bool catalog_server::has_idle_thread()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return pending.size() + active.size() < threads;
+}
+
+void catalog_server::run(int listen_fd)
+{
+  std::vector<std::thread> pool;
+  std::exception_ptr failure;
+
+  for (unsigned int i = 0; i < threads; ++i)
+    pool.emplace_back(&catalog_server::serve_connections, this);
+
+  bool backing_off = false;
+
+  try
+  {
+    for (;;)
+    {
+      // Connections are accepted only when a thread can serve them at once,
+      // so that the others wait in the accept queue of the socket and the
+      // idle timeout of a connection starts when it is accepted.  After a
+      // transient failure, accept() is retried after a delay.
+      bool accepting = !backing_off && has_idle_thread();
+      struct pollfd fds[3] = {
+        {accepting ? listen_fd : -1, POLLIN, 0},
+        {wakeup[0],                  POLLIN, 0},
+        {released[0],                POLLIN, 0}
+      };
+
+      int ready = ::poll(fds, 3, backing_off ? ACCEPT_RETRY_DELAY_MS : -1);
+
+      if (ready < 0)
+      {
+        if (errno == EINTR) continue;
+        throw std::system_error(errno, std::generic_category());
+      }
+
+      if (fds[1].revents != 0) break;
+
+      // A thread has finished serving a connection.
+      if (fds[2].revents != 0)
+      {
+        char c;
+        if (::read(released[0], &c, 1) < 0 && errno != EINTR)
+          throw std::system_error(errno, std::generic_category());
+      }
+
+      if (ready == 0) backing_off = false;
+      if (fds[0].revents == 0) continue;
+
+      int fd = ::accept(listen_fd, nullptr, nullptr);
+
+      if (fd < 0)
+      {
+        // The client may have gone away before its connection was accepted.
+        if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN)
+          continue;
+
+        if (is_transient_accept_error(errno))
+        {
+          backing_off = true;
+          continue;
+        }
+
+        throw std::system_error(errno, std::generic_category());
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(fd);
+      }
+
+      available.notify_one();
+    }
+  }
+  catch (...)
+  {
+    failure = std::current_exception();
+  }
+
+  // Wake up the threads blocked on a connection by shutting it down, and
+  // close the connections no thread has picked up yet.
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+
+    for (int fd : active) ::shutdown(fd, SHUT_RDWR);
+    for (int fd : pending) ::close(fd);
+
+    pending.clear();
+  }
+
+  available.notify_all();
+
+  for (auto& t : pool) t.join();
+
+  if (failure) std::rethrow_exception(failure);
+}
+
+void catalog_server::stop()
+{
+  // Only async-signal-safe functions are used.
+  char c = 0;
+
+  while (::write(wakeup[1], &c, 1) < 0 && errno == EINTR)
+  {
+  }
+}
+
+bool catalog_server::next_connection(int& fd)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  available.wait(lock, [this] { return stopping || !pending.empty(); });
+
+  if (stopping) return false;
+
+  fd = pending.front();
+  pending.pop_front();
+  active.insert(fd);
+
+  return true;
+}
+
+void catalog_server::serve_connections()
+{
+  int fd;
+
+  while (next_connection(fd))
+  {
+    try
+    {
+      // A read timing out fails with EAGAIN, which ends the connection.
+      if (idle_timeout > 0)
+      {
+        struct timeval timeout{};
+        timeout.tv_sec = idle_timeout;
+
+        if (::setsockopt(fd,
+                         SOL_SOCKET,
+                         SO_RCVTIMEO,
+                         &timeout,
+                         sizeof(timeout)) != 0)
+          throw std::system_error(errno, std::generic_category());
+      }
+
+      buffered_writer out(fd);
+      serve_requests(fd,
+                     out,
+                     [this](const std::vector<std::string_view>& args,
+                            std::string& response)
+                     {
+                       return execute_catalog_request(store,
+                                                      catalog_dir,
+                                                      args,
+                                                      response);
+                     });
+    }
+    catch (std::exception& ex)
+    {
+      // The client has gone away, or its connection failed: nothing can be
+      // reported to it, and the worker must survive to serve the others.
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      active.erase(fd);
+    }
+
+    ::close(fd);
+
+    // The accepting thread waits for a thread to be available.
+    char c = 0;
+
+    while (::write(released[1], &c, 1) < 0 && errno == EINTR)
+    {
+    }
+  }
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Version catalogs shared by the clients of semverd.
+ *
+ * semverd extends the line protocol of protocol.hpp with named catalogs, which
+ * are parsed and sorted once and then queried by any number of clients:
+ *
+ *   - `load name file`: loads the whitespace-separated versions of @e file
+ *     into the catalog @e name and answers the number of versions.  @e file
+ *     is the name of a regular file of the catalog directory of the server:
+ *     it cannot contain a slash nor be a symbolic link, and `load` fails if
+ *     the server has no catalog directory.
+ *   - `define name version...`: same as `load`, taking the versions from the
+ *     request.
+ *   - `add name version...`, `remove name version...`: adds versions to or
+ *     removes versions from a catalog, creating it if needed, and answers the
+ *     number of versions actually added or removed.
+ *   - `drop name`: removes a catalog.
+ *   - `catalogs`: the names of the catalogs, separated by spaces.
+ *   - `max @name constraint...`, `min @name constraint...`: the maximum or
+ *     minimum version of a catalog satisfying all the constraints.
+ *   - `sort @name constraint...`, `satisfies @name constraint...`: the versions
+ *     of a catalog satisfying all the constraints, in ascending order.
+ *   - `latest @name major`: the latest release of a catalog in a major line.
+ *
+ * A constraint is a version optionally prefixed by one of the operators `=`,
+ * `!=`, `<`, `<=`, `>` and `>=`; metadata is ignored.  The other requests are
+ * served by execute_request().
+ */
+#ifndef SEMVER_DAEMON_H
+#define SEMVER_DAEMON_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "libsemver/c++/catalog.hpp"
+#include "libsemver/c++/concurrent_catalog.hpp"
+#include "libsemver/c++/version.hpp"
+
+/**
+ * @brief Set of named catalogs of versions.
+ *
+ * Queries never wait for writers: both the set of catalogs and each catalog
+ * are read through immutable snapshots, which writers build aside and then
+ * publish, locking a mutex only to swap a pointer.  A query sees the catalog
+ * as it was when the query started, even if it is updated or dropped in the
+ * meantime.  Each update copies the catalog it changes, but concurrent
+ * additions and removals are combined into a single copy.
+ */
+class catalog_store
+{
+public:
+  /**
+   * @brief Stores @p versions as the catalog @p name, replacing the existing
+   * one, if any.
+   *
+   * @param name The name of the catalog.
+   * @param versions The versions of the catalog.
+   */
+  void put(const std::string& name, std::vector<semver::version> versions);
+
+  /**
+   * @brief Adds @p versions to the catalog @p name, creating it if it does not
+   * exist.
+   *
+   * @param name The name of the catalog.
+   * @param versions The versions to add.
+   * @return The number of versions that were not already in the catalog.
+   */
+  size_t add(const std::string& name, std::vector<semver::version> versions);
+
+  /**
+   * @brief Removes @p versions from the catalog @p name.
+   *
+   * @param name The name of the catalog.
+   * @param versions The versions to remove.
+   * @return The number of versions that were removed.
+   * @throws std::invalid_argument if the catalog does not exist.
+   */
+  size_t remove(std::string_view name,
+                const std::vector<semver::version>& versions);
+
+  /**
+   * @brief Calls @p reader on the current snapshot of the catalog @p name.
+   *
+   * @param name The name of the catalog.
+   * @param reader The function reading the catalog.
+   * @throws std::invalid_argument if the catalog does not exist.
+   */
+  void read(std::string_view name,
+            const std::function<void(const semver::catalog&)>& reader) const;
+
+  /**
+   * @brief Removes the catalog @p name.
+   *
+   * @param name The name of the catalog.
+   * @return `true` if the catalog existed, `false` otherwise.
+   */
+  bool erase(std::string_view name);
+
+  /**
+   * @brief Gets the names of the catalogs, in ascending order.
+   */
+  std::vector<std::string> names() const;
+
+private:
+  using catalog_map =
+    std::map<std::string,
+             std::shared_ptr<semver::concurrent_catalog>,
+             std::less<>>;
+
+  std::shared_ptr<semver::concurrent_catalog>
+  find(std::string_view name) const;
+  std::shared_ptr<const catalog_map> snapshot() const;
+  void publish(catalog_map map);
+
+  std::shared_ptr<const catalog_map> catalogs =
+    std::make_shared<const catalog_map>();
+  mutable std::mutex catalogs_mutex;
+  std::mutex writer;
+};
+
+/**
+ * @brief Parses the whitespace-separated versions contained in @p text.
+ *
+ * @param text The text to parse.
+ * @return The parsed versions.
+ * @throws std::invalid_argument if a token is not a valid version.
+ */
+std::vector<semver::version> parse_catalog(std::string_view text);
+
+/**
+ * @brief Executes a request of the semverd protocol.
+ *
+ * @param store The catalogs the request refers to.
+ * @param catalog_dir The directory `load` reads the catalogs from, or an
+ * empty string if `load` is disabled.
+ * @param args The request, split into tokens.
+ * @param response The string the response is appended to.
+ * @return `false` if the request ends the session, `true` otherwise.
+ * @throws std::invalid_argument if the request fails.
+ * @see execute_request()
+ */
+bool execute_catalog_request(catalog_store& store,
+                             const std::string& catalog_dir,
+                             const std::vector<std::string_view>& args,
+                             std::string& response);
+
+/**
+ * @brief Server accepting connections on a listening socket and serving each
+ * of them on a fixed pool of threads.
+ *
+ * A connection is assigned to a thread of the pool for its whole lifetime,
+ * and is accepted only when a thread of the pool is available: connections
+ * exceeding the size of the pool wait in the accept queue of the socket.
+ * Connections sending no request for longer than the idle timeout are closed,
+ * so that idle clients cannot hold all the threads.  When accept() fails for
+ * lack of file descriptors or memory, it is retried after a delay.
+ */
+class catalog_server
+{
+public:
+  /**
+   * @brief Constructs a server using @p threads threads to serve the requests
+   * on the catalogs of @p store.
+   *
+   * @param store The catalogs to serve.
+   * @param threads The number of threads of the pool.
+   * @param catalog_dir The directory `load` reads the catalogs from, or an
+   * empty string if `load` is disabled.
+   * @param idle_timeout The number of seconds after which an idle connection
+   * is closed, or 0 to never close idle connections.
+   * @throws std::system_error if the server cannot be initialized.
+   */
+  catalog_server(catalog_store& store,
+                 unsigned int threads,
+                 std::string catalog_dir,
+                 unsigned int idle_timeout);
+
+  ~catalog_server();
+
+  catalog_server(const catalog_server&) = delete;
+  catalog_server& operator=(const catalog_server&) = delete;
+
+  /**
+   * @brief Accepts connections on @p listen_fd until stop() is called.
+   *
+   * When this function returns, all the connections have been closed and all
+   * the threads of the pool have been joined.
+   *
+   * @param listen_fd The listening socket.
+   * @throws std::system_error if accept() fails with an error other than the
+   * transient ones.
+   */
+  void run(int listen_fd);
+
+  /**
+   * @brief Stops the server, closing the open connections.  This function can
+   * be called from any thread.
+   */
+  void stop();
+
+private:
+  // The delay after which accept() is retried after a transient failure.
+  static const int ACCEPT_RETRY_DELAY_MS = 100;
+
+  void serve_connections();
+  bool next_connection(int& fd);
+  bool has_idle_thread();
+
+  catalog_store& store;
+  unsigned int threads;
+  std::string catalog_dir;
+  unsigned int idle_timeout;
+  int wakeup[2];
+  // Written to by the threads of the pool when they finish a connection.
+  int released[2];
+  std::mutex mutex;
+  std::condition_variable available;
+  std::deque<int> pending;
+  std::set<int> active;
+  bool stopping = false;
+};
+
+#endif // SEMVER_DAEMON_H
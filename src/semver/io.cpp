@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "io.hpp"
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <fcntl.h> // open()
+#include <sys/mman.h> // mmap()
+#include <sys/stat.h> // fstat()
+#include <unistd.h> // read(), write()
+
+size_t read_fully(int fd, char *buf, size_t size)
+{
+  size_t total = 0;
+
+  while (total < size)
+  {
+    ssize_t n = ::read(fd, buf + total, size - total);
+
+    if (n == 0) break;
+    if (n < 0)
+    {
+      if (errno == EINTR) continue;
+      throw std::system_error(errno, std::generic_category());
+    }
+
+    total += static_cast<size_t>(n);
+  }
+
+  return total;
+}
+
+void split_tokens(std::string_view text, std::vector<std::string_view>& tokens)
+{
+  size_t i = 0;
+
+  while (i < text.size())
+  {
+    while (i < text.size() && is_separator(text[i])) ++i;
+
+    size_t begin = i;
+    while (i < text.size() && !is_separator(text[i])) ++i;
+
+    if (i > begin) tokens.push_back(text.substr(begin, i - begin));
+  }
+}
+
+mapped_input::mapped_input(const std::string& path)
+{
+  int fd;
+
+  do
+  {
+    fd = ::open(path.c_str(), O_RDONLY);
+  }
+  while (fd < 0 && errno == EINTR);
+
+  if (fd < 0)
+    throw std::system_error(errno, std::generic_category(), path);
+
+  try
+  {
+    load(fd);
+  }
+  catch (...)
+  {
+    ::close(fd);
+    throw;
+  }
+
+  ::close(fd);
+}
+
+mapped_input::mapped_input(int fd)
+{
+  load(fd);
+}
+
+mapped_input::~mapped_input()
+{
+  if (mapping) ::munmap(mapping, mapping_size);
+}
+
+std::string_view mapped_input::data() const
+{
+  return contents;
+}
+
+void mapped_input::load(int fd)
+{
+  struct stat st;
+
+  if (::fstat(fd, &st) != 0)
+    throw std::system_error(errno, std::generic_category());
+
+  // The contents start at the current offset, which is not 0 when part of
+  // the file has already been consumed, as with `(read line; semver) < file`.
+  // The mapping must start at a page boundary: the pages before the offset
+  // are mapped and skipped.
+  const off_t offset = S_ISREG(st.st_mode) ? ::lseek(fd, 0, SEEK_CUR) : -1;
+
+  if (offset >= 0 && offset < st.st_size)
+  {
+    const off_t start = offset - offset % ::sysconf(_SC_PAGESIZE);
+    const size_t size = static_cast<size_t>(st.st_size - start);
+    void *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, start);
+
+    if (addr != MAP_FAILED)
+    {
+      ::madvise(addr, size, MADV_SEQUENTIAL);
+      mapping = addr;
+      mapping_size = size;
+      contents = std::string_view(static_cast<const char *>(addr), size);
+      contents.remove_prefix(static_cast<size_t>(offset - start));
+      return;
+    }
+  }
+
+  // The file cannot be mapped: read it into the buffer, doubling its size as
+  // needed.
+  size_t used = 0;
+  buffer.resize(IO_BLOCK_SIZE);
+
+  for (;;)
+  {
+    size_t n = read_fully(fd, &buffer[used], buffer.size() - used);
+    used += n;
+
+    if (used < buffer.size()) break;
+
+    buffer.resize(2 * buffer.size());
+  }
+
+  buffer.resize(used);
+  contents = buffer;
+}
+
+block_reader::block_reader(int fd, size_t block_size) :
+  fd(fd), buffer(block_size)
+{
+}
+
+bool block_reader::fill()
+{
+  if (eof) return false;
+
+  // A single read is issued: waiting for a full block would delay the tokens
+  // already available on an interactive pipe.
+  for (;;)
+  {
+    ssize_t n = ::read(fd, buffer.data(), buffer.size());
+
+    if (n < 0)
+    {
+      if (errno == EINTR) continue;
+      throw std::system_error(errno, std::generic_category());
+    }
+
+    pos = 0;
+    end = static_cast<size_t>(n);
+    eof = (n == 0);
+
+    return !eof;
+  }
+}
+
+bool block_reader::next_line(std::string& line)
+{
+  line.clear();
+
+  if (pos == end && !fill()) return false;
+
+  // Collect the line, which may span multiple blocks.  The last line may lack
+  // the terminating newline.
+  for (;;)
+  {
+    const char *begin = buffer.data() + pos;
+    const char *nl = static_cast<const char *>(std::memchr(begin, '\n', end - pos));
+
+    if (nl != nullptr)
+    {
+      line.append(begin, nl);
+      pos += (nl - begin) + 1;
+      return true;
+    }
+
+    line.append(begin, end - pos);
+    pos = end;
+
+    if (!fill()) return true;
+  }
+}
+
+bool block_reader::buffered() const
+{
+  return pos < end;
+}
+
+buffered_writer::buffered_writer(int fd, size_t capacity) :
+  fd(fd), buffer(capacity)
+{
+}
+
+buffered_writer::~buffered_writer()
+{
+  try
+  {
+    flush();
+  }
+  catch (std::system_error& ex)
+  {
+    // Nothing sensible can be done at this point.
+  }
+}
+
+void buffered_writer::write(const char *data, size_t size)
+{
+  if (size > buffer.size() - used)
+  {
+    flush();
+
+    if (size >= buffer.size())
+    {
+      write_all(data, size);
+      return;
+    }
+  }
+
+  std::memcpy(buffer.data() + used, data, size);
+  used += size;
+}
+
+void buffered_writer::write(std::string_view s)
+{
+  write(s.data(), s.size());
+}
+
+void buffered_writer::put(char c)
+{
+  if (used == buffer.size()) flush();
+
+  buffer[used++] = c;
+}
+
+char *buffered_writer::reserve(size_t size)
+{
+  if (size > buffer.size() - used) flush();
+  if (size > buffer.size()) return nullptr;
+
+  return buffer.data() + used;
+}
+
+void buffered_writer::commit(size_t size)
+{
+  used += size;
+}
+
+void buffered_writer::flush()
+{
+  size_t size = used;
+  used = 0;
+
+  write_all(buffer.data(), size);
+}
+
+void buffered_writer::write_all(const char *data, size_t size)
+{
+  while (size > 0)
+  {
+    ssize_t n = ::write(fd, data, size);
+
+    if (n < 0)
+    {
+      if (errno == EINTR) continue;
+      throw std::system_error(errno, std::generic_category());
+    }
+
+    data += n;
+    size -= static_cast<size_t>(n);
+  }
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Block-oriented input and output used by the `semver` program.
+ *
+ * These classes read, map and write files in large blocks, bypassing `iostream`
+ * and its per-character locale processing.
+ */
+#ifndef SEMVER_IO_H
+#define SEMVER_IO_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Default size of the blocks read and written.
+ */
+const size_t IO_BLOCK_SIZE = 1 << 16;
+
+/**
+ * @brief Checks whether @p c separates two tokens.
+ *
+ * Separators are the characters of the `isspace()` class of the `C` locale.
+ */
+inline bool is_separator(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f'
+         || c == '\r';
+}
+
+/**
+ * @brief Reads up to @p size bytes from @p fd, retrying short reads.
+ *
+ * @return The number of bytes read.  Fewer than @p size bytes are returned
+ * only when the end of the input has been reached.
+ * @throws std::system_error if the file descriptor cannot be read.
+ */
+size_t read_fully(int fd, char *buf, size_t size);
+
+/**
+ * @brief Appends the whitespace-separated tokens of @p text to @p tokens.
+ *
+ * The tokens are views into @p text: no character is copied.
+ */
+void split_tokens(std::string_view text, std::vector<std::string_view>& tokens);
+
+/**
+ * @brief The whole contents of a file, mapped into memory.
+ *
+ * Regular files are mapped with `mmap()` and their contents are never copied.
+ * Other kinds of files, such as pipes and terminals, are read into a buffer
+ * owned by the instance.  The contents start at the current offset of the
+ * file.
+ */
+class mapped_input
+{
+public:
+  /**
+   * @brief Maps the file at @p path.
+   *
+   * @throws std::system_error if the file cannot be opened or read.
+   */
+  explicit mapped_input(const std::string& path);
+
+  /**
+   * @brief Maps the file open on @p fd.  The file descriptor is not closed.
+   *
+   * @throws std::system_error if the file cannot be read.
+   */
+  explicit mapped_input(int fd);
+
+  mapped_input(const mapped_input&) = delete;
+  mapped_input& operator=(const mapped_input&) = delete;
+  ~mapped_input();
+
+  /**
+   * @brief Gets the contents of the file.
+   *
+   * @return A view valid as long as this instance is alive.
+   */
+  std::string_view data() const;
+
+private:
+  void *mapping = nullptr;
+  size_t mapping_size = 0;
+  std::string buffer;
+  std::string_view contents;
+
+  void load(int fd);
+};
+
+/**
+ * @brief Splits the contents of a file descriptor into lines.
+ *
+ * Data is read as soon as it is available, so that lines can be processed
+ * while the other end of a pipe is still writing.
+ */
+class block_reader
+{
+public:
+  explicit block_reader(int fd, size_t block_size = IO_BLOCK_SIZE);
+  block_reader(const block_reader&) = delete;
+  block_reader& operator=(const block_reader&) = delete;
+
+  /**
+   * @brief Reads the next line.
+   *
+   * @param line The string the line, without its terminating newline, is
+   * stored into.  Its capacity is reused across calls.
+   * @return `true` if a line was read, `false` at the end of the input.
+   * @throws std::system_error if the file descriptor cannot be read.
+   */
+  bool next_line(std::string& line);
+
+  /**
+   * @brief Checks whether data is available without reading the file
+   * descriptor.
+   *
+   * @return `true` if the next call to next_line() will not block before
+   * returning some data.
+   */
+  bool buffered() const;
+
+private:
+  int fd;
+  std::vector<char> buffer;
+  size_t pos = 0;
+  size_t end = 0;
+  bool eof = false;
+
+  bool fill();
+};
+
+/**
+ * @brief Accumulates output in a block and writes it to a file descriptor when
+ * the block is full.
+ *
+ * Pending output is written when the instance is destroyed.
+ */
+class buffered_writer
+{
+public:
+  explicit buffered_writer(int fd, size_t capacity = IO_BLOCK_SIZE);
+  buffered_writer(const buffered_writer&) = delete;
+  buffered_writer& operator=(const buffered_writer&) = delete;
+  ~buffered_writer();
+
+  void write(const char *data, size_t size);
+  void write(std::string_view s);
+  void put(char c);
+
+  /**
+   * @brief Gets space for @p size bytes of output, flushing the pending output
+   * if needed.  The caller fills the space and then calls commit().
+   *
+   * @return A pointer to the space, or `nullptr` if @p size exceeds the
+   * capacity of the buffer.
+   * @throws std::system_error if the file descriptor cannot be written.
+   */
+  char *reserve(size_t size);
+
+  /**
+   * @brief Appends @p size bytes of the space returned by reserve() to the
+   * pending output.
+   */
+  void commit(size_t size);
+
+  /**
+   * @brief Writes the pending output.
+   *
+   * @throws std::system_error if the file descriptor cannot be written.
+   */
+  void flush();
+
+private:
+  int fd;
+  std::vector<char> buffer;
+  size_t used = 0;
+
+  void write_all(const char *data, size_t size);
+};
+
+#endif // SEMVER_IO_H
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "pipeline.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  // Size of the chunks the input is split into.  Chunks are large enough to
+  // amortize the synchronization cost over many thousands of tokens.
+  const size_t CHUNK_SIZE = 1 << 20;
+
+  struct chunk
+  {
+    size_t seq;
+    std::string data;
+    std::string_view text;
+
+    // Chunks read from a file descriptor own their data, the others are views
+    // into the caller's text.
+    std::string_view view() const
+    {
+      return data.empty() ? text : std::string_view(data);
+    }
+  };
+
+  struct chunk_result
+  {
+    std::string out;
+    std::string err;
+    int status = 0;
+    std::exception_ptr failure;
+  };
+
+  class ordered_pipeline
+  {
+  public:
+    ordered_pipeline(unsigned int jobs, const token_processor& process) :
+      jobs(jobs), max_in_flight(2 * jobs), process(process)
+    {
+    }
+
+    int run(int fd, buffered_writer& out, buffered_writer& err)
+    {
+      return run(std::thread(&ordered_pipeline::read_chunks, this, fd),
+                 out,
+                 err);
+    }
+
+    int run(std::string_view text, buffered_writer& out, buffered_writer& err)
+    {
+      return run(std::thread(&ordered_pipeline::split_chunks, this, text),
+                 out,
+                 err);
+    }
+
+  private:
+    unsigned int jobs;
+    size_t max_in_flight;
+    const token_processor& process;
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable space_available;
+    std::condition_variable result_available;
+    std::deque<chunk> pending;
+    std::map<size_t, chunk_result> results;
+    size_t produced = 0;
+    size_t in_flight = 0;
+    bool eof = false;
+    // Set when the results can no longer be written: the other threads give
+    // up instead of waiting for a consumer that is gone.
+    bool stopped = false;
+    std::exception_ptr failure;
+
+    int run(std::thread reader, buffered_writer& out, buffered_writer& err)
+    {
+      std::vector<std::thread> threads;
+      int ret = 0;
+
+      try
+      {
+        threads.push_back(std::move(reader));
+
+        for (unsigned int i = 0; i < jobs; ++i)
+          threads.emplace_back(&ordered_pipeline::process_chunks, this);
+
+        ret = write_results(out, err);
+      }
+      catch (...)
+      {
+        // Writing failed (EPIPE, for example) or a thread could not be
+        // started: the running threads must be woken up and joined before
+        // the failure is propagated.
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stopped = true;
+          failure = std::current_exception();
+        }
+
+        work_available.notify_all();
+        space_available.notify_all();
+      }
+
+      if (reader.joinable()) reader.join();
+      for (auto& t : threads) t.join();
+
+      if (failure) std::rethrow_exception(failure);
+
+      return ret;
+    }
+
+    // Returns false if the pipeline has been stopped and no more chunks must
+    // be submitted.
+    bool submit(std::string data, std::string_view text)
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      space_available.wait(lock, [this]
+      {
+        return in_flight < max_in_flight || stopped;
+      });
+
+      if (stopped) return false;
+
+      pending.push_back(chunk{produced++, std::move(data), text});
+      ++in_flight;
+      work_available.notify_one();
+
+      return true;
+    }
+
+    void finish()
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      eof = true;
+      work_available.notify_all();
+      result_available.notify_all();
+    }
+
+    void split_chunks(std::string_view text)
+    {
+      try
+      {
+        while (!text.empty())
+        {
+          size_t cut = std::min(CHUNK_SIZE, text.size());
+          while (cut < text.size() && !is_separator(text[cut])) ++cut;
+
+          if (!submit(std::string(), text.substr(0, cut))) break;
+          text.remove_prefix(cut);
+        }
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        failure = std::current_exception();
+      }
+
+      finish();
+    }
+
+    void read_chunks(int fd)
+    {
+      try
+      {
+        std::string carry;
+
+        for (;;)
+        {
+          std::string buf = std::move(carry);
+          carry.clear();
+
+          size_t start = buf.size();
+          buf.resize(start + CHUNK_SIZE);
+          size_t n = read_fully(fd, &buf[start], CHUNK_SIZE);
+          buf.resize(start + n);
+
+          if (n < CHUNK_SIZE)
+          {
+            if (!buf.empty()) submit(std::move(buf), std::string_view());
+            break;
+          }
+
+          // Cut the chunk after its last separator so that no token spans two
+          // chunks.  A chunk without separators is a single token that keeps
+          // growing until its end is found.
+          size_t cut = buf.size();
+          while (cut > 0 && !is_separator(buf[cut - 1])) --cut;
+
+          if (cut == 0)
+          {
+            carry = std::move(buf);
+            continue;
+          }
+
+          carry.assign(buf, cut, std::string::npos);
+          buf.resize(cut);
+
+          if (!submit(std::move(buf), std::string_view())) break;
+        }
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        failure = std::current_exception();
+      }
+
+      finish();
+    }
+
+    void process_chunks()
+    {
+      for (;;)
+      {
+        chunk c;
+
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          work_available.wait(lock, [this]
+          {
+            return !pending.empty() || eof || stopped;
+          });
+
+          if (stopped || pending.empty()) return;
+
+          c = std::move(pending.front());
+          pending.pop_front();
+        }
+
+        chunk_result r;
+
+        try
+        {
+          process_chunk(c.view(), r);
+        }
+        catch (...)
+        {
+          r.failure = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        results.emplace(c.seq, std::move(r));
+        result_available.notify_all();
+      }
+    }
+
+    void process_chunk(std::string_view data, chunk_result& r)
+    {
+      size_t i = 0;
+
+      while (i < data.size())
+      {
+        while (i < data.size() && is_separator(data[i])) ++i;
+
+        size_t begin = i;
+        while (i < data.size() && !is_separator(data[i])) ++i;
+
+        if (i == begin) break;
+
+        if (process(data.substr(begin, i - begin), r.out, r.err) != 0)
+          r.status = 1;
+      }
+    }
+
+    int write_results(buffered_writer& out, buffered_writer& err)
+    {
+      int ret = 0;
+
+      for (size_t next = 0;; ++next)
+      {
+        chunk_result r;
+
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          result_available.wait(lock, [this, next]
+          {
+            return results.count(next) != 0 || (eof && next == produced);
+          });
+
+          auto it = results.find(next);
+          if (it == results.end()) break;
+
+          r = std::move(it->second);
+          results.erase(it);
+          --in_flight;
+          space_available.notify_one();
+
+          if (r.failure && !failure) failure = r.failure;
+        }
+
+        out.write(r.out);
+        err.write(r.err);
+        if (r.status != 0) ret = 1;
+      }
+
+      return ret;
+    }
+  };
+}
+
+int run_pipeline(int fd,
+                 unsigned int jobs,
+                 const token_processor& process,
+                 buffered_writer& out,
+                 buffered_writer& err)
+{
+  ordered_pipeline pipeline(jobs == 0 ? 1 : jobs, process);
+
+  return pipeline.run(fd, out, err);
+}
+
+int run_pipeline(std::string_view text,
+                 unsigned int jobs,
+                 const token_processor& process,
+                 buffered_writer& out,
+                 buffered_writer& err)
+{
+  ordered_pipeline pipeline(jobs == 0 ? 1 : jobs, process);
+
+  return pipeline.run(text, out, err);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Chunked parallel processing of whitespace-separated tokens.
+ *
+ * The pipeline splits its input into large chunks, processes the chunks on a
+ * pool of worker threads and writes the results back in input order, so that
+ * the output of a parallel run is identical to the output of a sequential one.
+ */
+#ifndef SEMVER_PIPELINE_H
+#define SEMVER_PIPELINE_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include "io.hpp"
+
+/**
+ * @brief Function processing a single token.
+ *
+ * The function appends its regular output to @p out and its diagnostic output
+ * to @p err, and returns a non-zero value if the token could not be processed.
+ * The function is invoked concurrently from multiple threads.
+ */
+using token_processor = std::function<int(std::string_view token,
+                                          std::string& out,
+                                          std::string& err)>;
+
+/**
+ * @brief Processes the whitespace-separated tokens read from @p fd using
+ * @p jobs worker threads.
+ *
+ * A reader thread splits the input into chunks on token boundaries, the worker
+ * threads apply @p process to each token of a chunk, and the calling thread
+ * writes the results of each chunk to @p out and @p err in input order.
+ *
+ * @param fd The file descriptor to read from.
+ * @param jobs The number of worker threads.
+ * @param process The function applied to each token.
+ * @param out The writer regular output is written to.
+ * @param err The writer diagnostic output is written to.
+ * @return 0 if every token was processed successfully, 1 otherwise.
+ * @throws std::system_error if the input cannot be read or the output cannot
+ * be written.  All the threads have been joined when the exception is thrown.
+ */
+int run_pipeline(int fd,
+                 unsigned int jobs,
+                 const token_processor& process,
+                 buffered_writer& out,
+                 buffered_writer& err);
+
+/**
+ * @brief Processes the whitespace-separated tokens of @p text using @p jobs
+ * worker threads.
+ *
+ * This overload behaves like the overload reading a file descriptor, except
+ * that chunks are views into @p text and no input is copied.
+ */
+int run_pipeline(std::string_view text,
+                 unsigned int jobs,
+                 const token_processor& process,
+                 buffered_writer& out,
+                 buffered_writer& err);
+
+#endif // SEMVER_PIPELINE_H
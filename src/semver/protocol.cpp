@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "protocol.hpp"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include "libsemver/gettext_defs.h"
+#include "libsemver/c++/version.hpp"
+
+// Maximum number of arguments of variadic commands.
+static const size_t ANY = std::numeric_limits<size_t>::max();
+
+static std::vector<semver::version>
+parse_versions(const std::vector<std::string_view>& args)
+{
+  std::vector<semver::version> versions;
+  versions.reserve(args.size() - 1);
+
+  for (size_t i = 1; i < args.size(); ++i)
+    versions.push_back(semver::version::from_string(args[i]));
+
+  return versions;
+}
+
+static void check_arguments(const std::vector<std::string_view>& args,
+                            size_t min,
+                            size_t max)
+{
+  if (args.size() - 1 < min || args.size() - 1 > max)
+    throw std::invalid_argument(_("Invalid number of arguments."));
+}
+
+bool parse_number(std::string_view s, unsigned long max, unsigned long& n)
+{
+  if (s.empty()) return false;
+
+  n = 0;
+
+  for (char c : s)
+  {
+    if (c < '0' || c > '9') return false;
+
+    unsigned long digit = static_cast<unsigned long>(c - '0');
+    if (n > (max - digit) / 10) return false;
+
+    n = n * 10 + digit;
+  }
+
+  return true;
+}
+
+unsigned int parse_component_index(std::string_view component)
+{
+  if (component == "M" || component == "major") return 0;
+  if (component == "m" || component == "minor") return 1;
+  if (component == "p" || component == "patch") return 2;
+
+  // Indexes have at most nine digits, as many as always fit.
+  unsigned long index;
+
+  if (!parse_number(component, 999999999, index))
+    throw std::invalid_argument(
+      _("Invalid version index: ") + std::string(component));
+
+  return static_cast<unsigned int>(index);
+}
+
+semver::version bump_component(const semver::version& v, unsigned int index)
+{
+  if (index >= v.get_version_count() + MAX_ADDED_COMPONENTS)
+    throw std::invalid_argument(
+      _("Invalid version index: ") + std::to_string(index));
+
+  return v.bump(index);
+}
+
+bool execute_request(const std::vector<std::string_view>& args,
+                     std::string& response)
+{
+  if (args.empty())
+    throw std::invalid_argument(_("Invalid number of arguments."));
+
+  const std::string_view command = args[0];
+
+  if (command == "quit")
+  {
+    return false;
+  }
+  else if (command == "validate")
+  {
+    check_arguments(args, 1, ANY);
+    parse_versions(args);
+    response += "ok";
+  }
+  else if (command == "compare")
+  {
+    check_arguments(args, 2, 2);
+    semver::version lh =
+      semver::version::from_string(args[1]).strip_metadata();
+    semver::version rh =
+      semver::version::from_string(args[2]).strip_metadata();
+
+    response += (lh == rh) ? '=' : (lh < rh ? '<' : '>');
+  }
+  else if (command == "bump")
+  {
+    check_arguments(args, 2, 2);
+    unsigned int index = parse_component_index(args[1]);
+    bump_component(semver::version::from_string(args[2]), index)
+      .format_to(std::back_inserter(response));
+  }
+  else if (command == "max" || command == "min")
+  {
+    check_arguments(args, 1, ANY);
+    std::vector<semver::version> versions = parse_versions(args);
+
+    auto v = (command == "max")
+             ? std::max_element(versions.begin(), versions.end())
+             : std::min_element(versions.begin(), versions.end());
+    v->format_to(std::back_inserter(response));
+  }
+  else if (command == "sort")
+  {
+    check_arguments(args, 1, ANY);
+    std::vector<semver::version> versions = parse_versions(args);
+    std::stable_sort(versions.begin(), versions.end());
+
+    for (size_t i = 0; i < versions.size(); ++i)
+    {
+      if (i > 0) response += ' ';
+      versions[i].format_to(std::back_inserter(response));
+    }
+  }
+  else
+  {
+    throw std::invalid_argument(
+      _("Unknown command: ") + std::string(command));
+  }
+
+  return true;
+}
+
+void serve_requests(int fd,
+                    buffered_writer& out,
+                    const request_handler& handler)
+{
+  block_reader reader(fd);
+  std::string line;
+  std::string response;
+  std::vector<std::string_view> args;
+
+  while (reader.next_line(line))
+  {
+    args.clear();
+    response.clear();
+    split_tokens(line, args);
+
+    try
+    {
+      if (!handler(args, response)) break;
+    }
+    catch (std::exception& ex)
+    {
+      response = "! ";
+      response += ex.what();
+    }
+
+    out.write(response);
+    out.put('\n');
+
+    if (!reader.buffered()) out.flush();
+  }
+
+  out.flush();
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Line protocol used to serve requests from long-lived processes.
+ *
+ * Each request is a line made of a command followed by its whitespace-separated
+ * arguments, and each request is answered by exactly one response line:
+ *
+ *   - `validate version...`: `ok` if all the versions are valid.
+ *   - `compare version version`: `<`, `=` or `>`.
+ *   - `bump component version`: the bumped version.
+ *   - `max version...`, `min version...`: the maximum or minimum version.
+ *   - `sort version...`: the versions in ascending order, separated by spaces.
+ *   - `quit`: ends the session without a response.
+ *
+ * Failed requests are answered with the error message prefixed by `! `,
+ * whatever the exception the request failed with.
+ */
+#ifndef SEMVER_PROTOCOL_H
+#define SEMVER_PROTOCOL_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "io.hpp"
+#include "libsemver/c++/version.hpp"
+
+/**
+ * @brief The maximum number of components a bump can add to a version.
+ */
+constexpr unsigned int MAX_ADDED_COMPONENTS = 16;
+
+/**
+ * @brief Parses a plain decimal number.
+ *
+ * Unlike std::stoul(), no whitespace and no sign are accepted, so that
+ * negative numbers are not wrapped around.
+ *
+ * @param s The number to parse.
+ * @param max The greatest number accepted.
+ * @param n The number the result is stored into.
+ * @return `true` if @p s is made only of digits and is not greater than
+ * @p max, `false` otherwise.
+ */
+bool parse_number(std::string_view s, unsigned long max, unsigned long& n);
+
+/**
+ * @brief Parses the name or the index of a version component.
+ *
+ * @param component `M` or `major`, `m` or `minor`, `p` or `patch`, or the
+ * zero-based index of the component.
+ * @return The index of the component.
+ * @throws std::invalid_argument if @p component is not valid.
+ */
+unsigned int parse_component_index(std::string_view component);
+
+/**
+ * @brief Bumps the component of @p v at @p index.
+ *
+ * Unlike semver::version::bump(), the index is bounded: bumping a component
+ * beyond the last one adds at most #MAX_ADDED_COMPONENTS components, so that
+ * the untrusted index of a request cannot exhaust the memory.  The `semver`
+ * command line, whose index is given by the user, calls
+ * semver::version::bump() directly.
+ *
+ * @param v The version to bump.
+ * @param index The zero-based index of the component.
+ * @return The bumped version.
+ * @throws std::invalid_argument if @p index is out of bounds.
+ */
+semver::version bump_component(const semver::version& v, unsigned int index);
+
+/**
+ * @brief Executes the request whose command and arguments are @p args.
+ *
+ * @param args The request, split into tokens.
+ * @param response The string the response is appended to, without the
+ * terminating newline.
+ * @return `false` if the request ends the session, `true` otherwise.
+ * @throws std::invalid_argument if the request fails.
+ */
+bool execute_request(const std::vector<std::string_view>& args,
+                     std::string& response);
+
+/**
+ * @brief Function executing a request, with the same contract as
+ * execute_request().
+ */
+using request_handler =
+  std::function<bool(const std::vector<std::string_view>& args,
+                     std::string& response)>;
+
+/**
+ * @brief Serves the requests read from @p fd until the end of the input or a
+ * `quit` request.
+ *
+ * A request failing with any `std::exception` is answered with an error
+ * response, and does not end the session.  Responses are flushed to @p out
+ * whenever no further request is available without blocking.
+ *
+ * @param fd The file descriptor requests are read from.
+ * @param out The writer responses are written to.
+ * @param handler The function executing each request.
+ * @throws std::system_error if @p fd cannot be read or @p out written.
+ */
+void serve_requests(int fd,
+                    buffered_writer& out,
+                    const request_handler& handler = execute_request);
+
+#endif // SEMVER_PROTOCOL_H
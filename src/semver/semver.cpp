@@ -15,10 +15,17 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric> // iota
 #include <getopt.h>
 #include <unistd.h> // isatty()
-#include <cstdio> // fileno()
+#include <system_error>
+#include <string_view>
+#include <thread>
 #include <vector>
 #ifdef HAVE_CONFIG_H
 #  include "libsemver_config.h"
@@ -28,32 +35,66 @@
 #endif
 #include "libsemver/gettext.h"
 #include "libsemver/gettext_defs.h"
+#include "libsemver/c++/frozen_set.hpp"
+#include "libsemver/c++/scanner.hpp"
+#include "libsemver/c++/validation.hpp"
 #include "libsemver/c++/version.hpp"
+#include "libsemver/c++/version_arena.hpp"
+#include "io.hpp"
+#include "pipeline.hpp"
+#include "protocol.hpp"
 
 static const int OPT_VERSION = 128;
+static const int OPT_INPUT = 129;
+static const int OPT_BATCH = 130;
+static const int OPT_SERVE_STDIO = 131;
+static const int OPT_IN_SET = 132;
 static const int SEMVER_EXIT_OK = 0;
 
 static bool command_set = false;
+static bool batch = false;
 static bool Mflag = false;
 static bool bflag = false;
 static bool cflag = false;
+static bool eflag = false;
+static bool serve_stdio = false;
 static bool mflag = false;
 static bool rflag = false;
 static bool sflag = false;
 static bool vflag = false;
+static unsigned int jobs = 1;
 static std::string component_to_bump;
+static std::string set_path;
+static unsigned int index_to_bump;
+static std::vector<std::string> input_paths;
+static std::vector<std::unique_ptr<mapped_input>> inputs;
+static buffered_writer output(STDOUT_FILENO);
 
 static void parse_opts(int argc, char **argv);
-static std::vector<std::string> read_arguments(int argc, char **argv);
+static std::vector<std::string_view> read_arguments(int argc, char **argv);
+static void map_inputs();
+static void map_standard_input();
 static void usage(std::ostream& stream);
-
-static int max_version(const std::vector<std::string>& version);
-static int bump_versions(const std::vector<std::string>& version);
-static int check_versions(const std::vector<std::string>& version);
-static int compare_versions(const std::vector<std::string>& version);
-static int min_version(const std::vector<std::string>& version);
-static int sort_versions(const std::vector<std::string>& version);
+static bool parse_index_to_bump();
+static int parallel_versions(int argc, char **argv);
+static int run_command(const std::vector<std::string_view>& args);
+
+static int max_version(const std::vector<std::string_view>& version);
+static int bump_versions(const std::vector<std::string_view>& version);
+static int check_versions(const std::vector<std::string_view>& version);
+static int bump_version(std::string_view v, std::string& out, std::string& err);
+static int check_version(std::string_view v, std::string& err);
+static int compare_versions(const std::vector<std::string_view>& version);
+static int compare_pair(std::string_view first, std::string_view second);
+static int batch_compare_versions(int argc);
+static int extract_versions(int argc, char **argv);
+static int filter_versions(const std::vector<std::string_view>& version);
+static int min_version(const std::vector<std::string_view>& version);
+static int sort_versions(const std::vector<std::string_view>& version);
 static void print_version();
+static void write_version(const semver::version& v);
+static int parse_versions(const std::vector<std::string_view>& version,
+                          semver::version_arena& arena);
 
 int main(int argc, char **argv)
 {
@@ -63,6 +104,10 @@ int main(int argc, char **argv)
   textdomain(PACKAGE);
 #endif
 
+  // Versions are read and written through mapped_input and buffered_writer:
+  // iostream is only used for diagnostics.
+  std::ios::sync_with_stdio(false);
+
   parse_opts(argc, argv);
 
   if (!command_set)
@@ -71,19 +116,79 @@ int main(int argc, char **argv)
     exit(1);
   }
 
-  // Extract arguments from the command line and for the pipe.
-  std::vector<std::string> args = read_arguments(argc, argv);
+  if (bflag && !parse_index_to_bump()) return 1;
 
-  // validate options
-  if (args.empty())
+  // A coprocess session serves requests until the end of the input.
+  if (serve_stdio)
   {
-    std::cerr << _("Invalid number of arguments.\n");
-    exit(1);
+    try
+    {
+      serve_requests(STDIN_FILENO, output);
+    }
+    catch (std::system_error& ex)
+    {
+      std::cerr << ex.what() << "\n";
+      return 1;
+    }
+
+    return 0;
+  }
+
+  map_inputs();
+
+  // Validate and bump stream their input through the parallel pipeline when
+  // more than one job is requested.
+  if (jobs > 1
+      && (bflag || vflag)
+      && (!inputs.empty() || !isatty(STDIN_FILENO)))
+    return parallel_versions(argc, argv);
+
+  // Batch comparison streams the standard input line by line.
+  if (batch) return batch_compare_versions(argc);
+
+  map_standard_input();
+
+  int ret;
+
+  if (eflag)
+  {
+    // Extraction scans the input as text instead of splitting it into versions.
+    ret = extract_versions(argc, argv);
+  }
+  else
+  {
+    // Extract arguments from the command line, the input files and the pipe.
+    std::vector<std::string_view> args = read_arguments(argc, argv);
+
+    // validate options
+    if (args.empty())
+    {
+      std::cerr << _("Invalid number of arguments.\n");
+      exit(1);
+    }
+
+    ret = run_command(args);
+  }
+
+  try
+  {
+    output.flush();
+  }
+  catch (std::system_error& ex)
+  {
+    std::cerr << ex.what() << "\n";
+    return 1;
   }
 
+  return ret;
+}
+
+int run_command(const std::vector<std::string_view>& args)
+{
   if (Mflag) return max_version(args);
   if (bflag) return bump_versions(args);
   if (cflag) return compare_versions(args);
+  if (!set_path.empty()) return filter_versions(args);
   if (mflag) return min_version(args);
   if (sflag) return sort_versions(args);
   if (vflag) return check_versions(args);
@@ -93,41 +198,36 @@ int main(int argc, char **argv)
   return 1;
 }
 
-int max_version(const std::vector<std::string>& version)
+// Writes a version followed by a newline directly into the output buffer.
+void write_version(const semver::version& v)
 {
-  int ret = 0;
-  std::vector<semver::version> versions;
+  size_t size = v.formatted_size() + 1;
+  char *buf = output.reserve(size);
 
-  for (auto& v : version)
+  if (buf == nullptr)
   {
-    try
-    {
-      versions.push_back(semver::version::from_string(v));
-    }
-    catch (std::invalid_argument& ex)
-    {
-      std::cerr << ex.what() << "\n";
-      ret = 1;
-    }
+    output.write(v.str());
+    output.put('\n');
+    return;
   }
 
-  std::cout
-    << (*std::max_element(std::begin(versions), std::end(versions))).str()
-    << "\n";
-
-  return ret;
+  v.write(buf, size);
+  buf[size - 1] = '\n';
+  output.commit(size);
 }
 
-int min_version(const std::vector<std::string>& version)
+// Parses the versions into the arena, reporting the invalid ones.
+int parse_versions(const std::vector<std::string_view>& version,
+                   semver::version_arena& arena)
 {
   int ret = 0;
-  std::vector<semver::version> versions;
+  arena.reserve(version.size());
 
   for (auto& v : version)
   {
     try
     {
-      versions.push_back(semver::version::from_string(v));
+      arena.parse(v);
     }
     catch (std::invalid_argument& ex)
     {
@@ -136,63 +236,98 @@ int min_version(const std::vector<std::string>& version)
     }
   }
 
-  std::cout
-    << (*std::min_element(std::begin(versions), std::end(versions))).str()
-    << "\n";
+  return ret;
+}
+
+int max_version(const std::vector<std::string_view>& version)
+{
+  semver::version_arena arena;
+  int ret = parse_versions(version, arena);
+
+  if (!arena.empty())
+  {
+    semver::version_arena::handle max = 0;
+
+    for (semver::version_arena::handle h = 1; h < arena.size(); ++h)
+      if (arena[max] < arena[h]) max = h;
+
+    write_version(arena[max]);
+  }
 
   return ret;
 }
 
-int bump_versions(const std::vector<std::string>& version)
+int min_version(const std::vector<std::string_view>& version)
 {
-  unsigned int index_to_bump;
+  semver::version_arena arena;
+  int ret = parse_versions(version, arena);
+
+  if (!arena.empty())
+  {
+    semver::version_arena::handle min = 0;
+
+    for (semver::version_arena::handle h = 1; h < arena.size(); ++h)
+      if (arena[h] < arena[min]) min = h;
+
+    write_version(arena[min]);
+  }
+
+  return ret;
+}
 
-  if (component_to_bump == "M" || component_to_bump == "major")
+bool parse_index_to_bump()
+{
+  try
   {
-    index_to_bump = 0;
+    index_to_bump = parse_component_index(component_to_bump);
   }
-  else if (component_to_bump == "m" || component_to_bump == "minor")
+  catch (std::invalid_argument& ex)
   {
-    index_to_bump = 1;
+    std::cerr << ex.what() << "\n";
+    return false;
   }
-  else if (component_to_bump == "p" || component_to_bump == "patch")
+
+  return true;
+}
+
+int bump_version(std::string_view v, std::string& out, std::string& err)
+{
+  try
   {
-    index_to_bump = 2;
+    semver::version::from_string(v).bump(index_to_bump)
+      .format_to(std::back_inserter(out));
+    out += "\n";
+    return 0;
   }
-  else
+  catch (std::invalid_argument& ex)
   {
-    try
-    {
-      index_to_bump = (unsigned int) std::stoul(component_to_bump);
-    }
-    catch (std::invalid_argument& ex)
-    {
-      std::cerr << _("Invalid version index: ") << component_to_bump << "\n";
-      return 1;
-    }
+    err += ex.what();
+    err += "\n";
+    return 1;
   }
+}
 
+int bump_versions(const std::vector<std::string_view>& version)
+{
   int ret = 0;
+  std::string out;
+  std::string err;
 
   for (auto& v : version)
   {
-    try
-    {
-      std::cout
-        << semver::version::from_string(v).bump(index_to_bump).str()
-        << "\n";
-    }
-    catch (std::invalid_argument& ex)
-    {
-      std::cerr << ex.what() << "\n";
-      ret = 1;
-    }
+    out.clear();
+    err.clear();
+
+    if (bump_version(v, out, err) != 0) ret = 1;
+
+    std::cerr << err;
+    output.write(out);
   }
 
   return ret;
 }
 
-int compare_versions(const std::vector<std::string>& version)
+int compare_versions(const std::vector<std::string_view>& version)
 {
   if (version.size() != 2)
   {
@@ -202,13 +337,7 @@ int compare_versions(const std::vector<std::string>& version)
 
   try
   {
-    semver::version first =
-      semver::version::from_string(version[0]).strip_metadata();
-    semver::version second =
-      semver::version::from_string(version[1]).strip_metadata();
-
-    if (first == second) return 0;
-    return first < second ? 1 : 2;
+    return compare_pair(version[0], version[1]);
   }
   catch (std::invalid_argument& ex)
   {
@@ -217,48 +346,139 @@ int compare_versions(const std::vector<std::string>& version)
   }
 }
 
-int sort_versions(const std::vector<std::string>& version)
+int compare_pair(std::string_view first, std::string_view second)
+{
+  semver::version lh = semver::version::from_string(first).strip_metadata();
+  semver::version rh = semver::version::from_string(second).strip_metadata();
+
+  if (lh == rh) return 0;
+  return lh < rh ? 1 : 2;
+}
+
+int batch_compare_versions(int argc)
 {
+  if (optind != argc)
+  {
+    std::cerr << _("Invalid number of arguments.\n");
+    return 1;
+  }
+
   int ret = 0;
-  std::vector<semver::version> versions;
+  std::vector<std::string_view> pair;
+  std::string err;
 
-  for (auto& v : version)
+  // Each line produces exactly one line of output: the comparison result, or
+  // the error prefixed by '!'.
+  auto compare_line = [&](std::string_view line)
   {
+    pair.clear();
+    split_tokens(line, pair);
+
     try
     {
-      versions.push_back(semver::version::from_string(v));
+      if (pair.size() != 2)
+        throw std::invalid_argument(_("Invalid number of arguments."));
+
+      output.put("=<>"[compare_pair(pair[0], pair[1])]);
+      output.put('\n');
     }
     catch (std::invalid_argument& ex)
     {
-      std::cerr << ex.what() << "\n";
-      ret = 1;
+      output.write("! ");
+      output.write(ex.what());
+      output.put('\n');
+      ret = 4;
     }
-  }
+  };
 
-  if (rflag)
-    std::sort(versions.begin(),
-              versions.end(),
-              std::greater<semver::version>());
-  else
-    std::sort(versions.begin(), versions.end());
+  try
+  {
+    for (const auto& input : inputs)
+    {
+      std::string_view text = input->data();
+
+      while (!text.empty())
+      {
+        size_t nl = text.find('\n');
+        compare_line(text.substr(0, nl));
+        text.remove_prefix(nl == std::string_view::npos ? text.size() : nl + 1);
+      }
+    }
+
+    if (inputs.empty())
+    {
+      block_reader reader(STDIN_FILENO);
+      std::string line;
+
+      while (reader.next_line(line))
+      {
+        compare_line(line);
+
+        // Flush the results before waiting for more input, so that a process
+        // writing pairs to the pipe can read the results as they are produced.
+        if (!reader.buffered()) output.flush();
+      }
+    }
 
-  for (auto& ver : versions)
+    output.flush();
+  }
+  catch (std::system_error& ex)
   {
-    std::cout << ver.str() << "\n";
+    std::cerr << ex.what() << "\n";
+    return 1;
   }
 
   return ret;
 }
 
-int check_versions(const std::vector<std::string>& version)
+int filter_versions(const std::vector<std::string_view>& version)
 {
+  std::unique_ptr<mapped_input> set_input;
+
+  try
+  {
+    set_input = std::make_unique<mapped_input>(set_path);
+  }
+  catch (std::system_error& ex)
+  {
+    std::cerr << ex.what() << "\n";
+    return 1;
+  }
+
+  std::vector<std::string_view> tokens;
+  split_tokens(set_input->data(), tokens);
+
+  std::vector<semver::version> members;
+  members.reserve(tokens.size());
+
+  for (auto& t : tokens)
+  {
+    try
+    {
+      members.push_back(semver::version::from_string(t));
+    }
+    catch (std::invalid_argument& ex)
+    {
+      std::cerr << set_path << ": " << ex.what() << "\n";
+      return 1;
+    }
+  }
+
+  // The set is queried once per input version: it is frozen after it has been
+  // loaded, so that each query takes constant time.
+  const semver::frozen_set set(members);
+  members.clear();
+
   int ret = 0;
 
-  for (const auto& v : version)
+  for (auto& v : version)
   {
     try
     {
-      semver::version::from_string(v);
+      if (!set.contains(semver::version::from_string(v))) continue;
+
+      output.write(v);
+      output.put('\n');
     }
     catch (std::invalid_argument& ex)
     {
@@ -270,39 +490,213 @@ int check_versions(const std::vector<std::string>& version)
   return ret;
 }
 
-std::vector<std::string> read_arguments(int argc, char **argv)
+int sort_versions(const std::vector<std::string_view>& version)
 {
-  std::vector<std::string> arguments;
+  semver::version_arena arena;
+  int ret = parse_versions(version, arena);
 
-  for (auto i = optind; i < argc; ++i) arguments.emplace_back(argv[i]);
+  // The handles are sorted instead of the versions themselves.
+  std::vector<semver::version_arena::handle> handles(arena.size());
+  std::iota(handles.begin(), handles.end(), 0);
+
+  if (rflag)
+    std::sort(handles.begin(),
+              handles.end(),
+              [&arena](auto lh, auto rh) { return arena[rh] < arena[lh]; });
+  else
+    std::sort(handles.begin(),
+              handles.end(),
+              [&arena](auto lh, auto rh) { return arena[lh] < arena[rh]; });
+
+  for (auto h : handles) write_version(arena[h]);
+
+  return ret;
+}
+
+int check_version(std::string_view v, std::string& err)
+{
+  if (semver::is_valid(v)) return 0;
+
+  err += _("Invalid version: ");
+  err += v;
+  err += "\n";
+  return 1;
+}
+
+int check_versions(const std::vector<std::string_view>& version)
+{
+  int ret = 0;
+  std::string err;
 
-  // Read arguments from the standard input, if the program is not connected to
-  // a terminal
-  std::string pipe_input;
-  if (!isatty(fileno(stdin)))
+  for (const auto& v : version)
   {
-    while (std::cin >> pipe_input)
+    err.clear();
+
+    if (check_version(v, err) != 0) ret = 1;
+
+    std::cerr << err;
+  }
+
+  return ret;
+}
+
+int extract_versions(int argc, char **argv)
+{
+  int ret = 1;
+
+  auto extract = [&ret](std::string_view text)
+  {
+    semver::scanner scanner(text);
+    std::string_view match;
+
+    while (scanner.next(match))
     {
-      arguments.push_back(std::move(pipe_input));
+      output.write(match);
+      output.put('\n');
+      ret = 0;
     }
+  };
+
+  for (auto i = optind; i < argc; ++i) extract(argv[i]);
+  for (const auto& input : inputs) extract(input->data());
+
+  return ret;
+}
+
+int parallel_versions(int argc, char **argv)
+{
+  // Validation writes nothing to the standard output.
+  token_processor command =
+    bflag ? token_processor(bump_version)
+          : [](std::string_view v, std::string&, std::string& err)
+            {
+              return check_version(v, err);
+            };
+
+  // As in the sequential path, an empty input is an error.  The flag is only
+  // written by the first token, so that the workers do not contend for it.
+  std::atomic<bool> processed(false);
+  token_processor process =
+    [&command, &processed](std::string_view v,
+                           std::string& out,
+                           std::string& err)
+    {
+      if (!processed.load(std::memory_order_relaxed))
+        processed.store(true, std::memory_order_relaxed);
+
+      return command(v, out, err);
+    };
+  int ret = 0;
+
+  // Arguments on the command line precede the ones read from the pipe.
+  std::string out;
+  std::string err;
+
+  for (auto i = optind; i < argc; ++i)
+  {
+    if (process(argv[i], out, err) != 0) ret = 1;
   }
 
+  try
+  {
+    buffered_writer errors(STDERR_FILENO);
+    output.write(out);
+    errors.write(err);
+
+    if (inputs.empty())
+    {
+      if (run_pipeline(STDIN_FILENO, jobs, process, output, errors) != 0)
+        ret = 1;
+    }
+
+    for (const auto& input : inputs)
+    {
+      if (run_pipeline(input->data(), jobs, process, output, errors) != 0)
+        ret = 1;
+    }
+
+    output.flush();
+    errors.flush();
+  }
+  catch (std::system_error& ex)
+  {
+    std::cerr << ex.what() << "\n";
+    return 1;
+  }
+
+  if (!processed)
+  {
+    std::cerr << _("Invalid number of arguments.\n");
+    return 1;
+  }
+
+  return ret;
+}
+
+void map_inputs()
+{
+  try
+  {
+    for (const auto& path : input_paths)
+      inputs.push_back(std::make_unique<mapped_input>(path));
+  }
+  catch (std::system_error& ex)
+  {
+    std::cerr << ex.what() << "\n";
+    exit(1);
+  }
+}
+
+void map_standard_input()
+{
+  // Read the standard input, if no input file was specified and the program is
+  // not connected to a terminal
+  if (!inputs.empty() || isatty(STDIN_FILENO)) return;
+
+  try
+  {
+    inputs.push_back(std::make_unique<mapped_input>(STDIN_FILENO));
+  }
+  catch (std::system_error& ex)
+  {
+    std::cerr << ex.what() << "\n";
+    exit(1);
+  }
+}
+
+std::vector<std::string_view> read_arguments(int argc, char **argv)
+{
+  std::vector<std::string_view> arguments;
+
+  for (auto i = optind; i < argc; ++i) arguments.emplace_back(argv[i]);
+
+  // Arguments are views into the inputs, which stay mapped until the program
+  // exits.
+  for (const auto& input : inputs) split_tokens(input->data(), arguments);
+
   return arguments;
 }
 
 void parse_opts(int argc, char **argv)
 {
   int ch;
-  std::string short_options = "Mb:chmrsv";
+  unsigned long n;
+  std::string short_options = "Mb:cehj:mrsv";
 
   int option_index = 0;
   static struct option long_options[] = {
+    {"batch",    no_argument,       nullptr, OPT_BATCH},
     {"bump",     required_argument, nullptr, 'b'},
     {"compare",  no_argument,       nullptr, 'c'},
+    {"extract",  no_argument,       nullptr, 'e'},
     {"help",     no_argument,       nullptr, 'h'},
+    {"in-set",   required_argument, nullptr, OPT_IN_SET},
+    {"input",    required_argument, nullptr, OPT_INPUT},
+    {"jobs",     required_argument, nullptr, 'j'},
     {"max",      no_argument,       nullptr, 'M'},
     {"min",      no_argument,       nullptr, 'm'},
     {"reverse",  no_argument,       nullptr, 'r'},
+    {"serve-stdio", no_argument,    nullptr, OPT_SERVE_STDIO},
     {"sort",     no_argument,       nullptr, 's'},
     {"validate", no_argument,       nullptr, 'v'},
     {"version",  no_argument,       nullptr, OPT_VERSION},
@@ -333,10 +727,27 @@ void parse_opts(int argc, char **argv)
       cflag = true;
       break;
 
+    case 'e':
+      command_set = true;
+      eflag = true;
+      break;
+
     case 'h':
       usage(std::cout);
       exit(0);
 
+    case 'j':
+      if (!parse_number(optarg, std::numeric_limits<unsigned int>::max(), n))
+      {
+        std::cerr << _("Invalid number of jobs: ") << optarg << "\n";
+        exit(1);
+      }
+
+      jobs = static_cast<unsigned int>(n);
+
+      if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+      break;
+
     case 'm':
       command_set = true;
       mflag = true;
@@ -356,6 +767,24 @@ void parse_opts(int argc, char **argv)
       vflag = true;
       break;
 
+    case OPT_BATCH:
+      batch = true;
+      break;
+
+    case OPT_SERVE_STDIO:
+      command_set = true;
+      serve_stdio = true;
+      break;
+
+    case OPT_INPUT:
+      input_paths.emplace_back(optarg);
+      break;
+
+    case OPT_IN_SET:
+      command_set = true;
+      set_path = std::string(optarg);
+      break;
+
     case OPT_VERSION:
       print_version();
       exit(SEMVER_EXIT_OK);
@@ -374,6 +803,18 @@ void parse_opts(int argc, char **argv)
     std::cerr << _("-r can only be used with -s.\n");
     exit(1);
   }
+
+  if (batch && !cflag)
+  {
+    std::cerr << _("--batch can only be used with -c.\n");
+    exit(1);
+  }
+
+  if (jobs > 1 && !bflag && !vflag)
+  {
+    std::cerr << _("-j can only be used with -b or -v.\n");
+    exit(1);
+  }
 }
 
 void print_version()
@@ -400,10 +841,16 @@ void usage(std::ostream& stream)
   stream << _("Options:\n");
   stream << " -M, --max             " << _("Find the maximum version.\n");
   stream << " -b, --bump component  " << _("Increment the specified version component.\n");
+  stream << "     --batch           " << _("Compare the pairs of versions read from each input line.\n");
   stream << " -c, --compare         " << _("Compare two versions.\n");
+  stream << " -e, --extract         " << _("Extract the versions contained in a text.\n");
   stream << " -h, --help            " << _("Show this message.\n");
+  stream << "     --in-set file     " << _("Print the versions contained in the set read from the specified file.\n");
+  stream << "     --input file      " << _("Read the versions from the specified file.\n");
+  stream << " -j, --jobs n          " << _("Process the standard input using n threads.\n");
   stream << " -m, --min             " << _("Find the minimum version.\n");
   stream << " -r, --reverse         " << _("Reverse the sort order.\n");
+  stream << "     --serve-stdio     " << _("Serve requests read from the standard input.\n");
   stream << " -s, --sort            " << _("Sort the versions.\n");
   stream << " -v, --validate        " << _("Validate a version.\n");
   stream << "\n";
@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <csignal>
+#include <getopt.h>
+#include <sys/socket.h>
+#include <sys/stat.h> // lstat()
+#include <sys/un.h>
+#include <unistd.h>
+#ifdef HAVE_CONFIG_H
+#  include "libsemver_config.h"
+#endif
+#ifdef HAVE_CMAKE_CONFIG_H
+#  include "cmake_config.h"
+#endif
+#include "libsemver/gettext.h"
+#include "libsemver/gettext_defs.h"
+#include "daemon.hpp"
+#include "io.hpp"
+#include "protocol.hpp"
+
+static const int OPT_VERSION = 128;
+static const int OPT_CLIENT = 129;
+static const int SEMVER_EXIT_OK = 0;
+static const unsigned int DEFAULT_IDLE_TIMEOUT = 300;
+
+static bool client = false;
+static unsigned int jobs = 0;
+static unsigned int idle_timeout = DEFAULT_IDLE_TIMEOUT;
+static std::string catalog_dir;
+static std::string socket_path;
+static std::vector<std::pair<std::string, std::string>> preloaded_catalogs;
+
+static void parse_opts(int argc, char **argv);
+static void usage(std::ostream& stream);
+static void print_version();
+static sockaddr_un socket_address(const std::string& path);
+static int run_client();
+static int run_server();
+static int open_listening_socket();
+static bool load_catalogs(catalog_store& store);
+
+int main(int argc, char **argv)
+{
+#ifdef ENABLE_NLS
+  setlocale(LC_ALL, "");
+  bindtextdomain(PACKAGE, LOCALEDIR);
+  textdomain(PACKAGE);
+#endif
+
+  std::ios::sync_with_stdio(false);
+
+  parse_opts(argc, argv);
+
+  // A peer going away must not kill the process: writes fail with EPIPE.
+  std::signal(SIGPIPE, SIG_IGN);
+
+  try
+  {
+    return client ? run_client() : run_server();
+  }
+  catch (std::system_error& ex)
+  {
+    std::cerr << socket_path << ": " << ex.what() << "\n";
+    return 1;
+  }
+}
+
+sockaddr_un socket_address(const std::string& path)
+{
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+
+  if (path.size() >= sizeof(address.sun_path))
+    throw std::system_error(ENAMETOOLONG, std::generic_category());
+
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+  return address;
+}
+
+int run_client()
+{
+  sockaddr_un address = socket_address(socket_path);
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+  if (fd < 0) throw std::system_error(errno, std::generic_category());
+
+  if (::connect(fd,
+                reinterpret_cast<sockaddr *>(&address),
+                sizeof(address)) != 0)
+  {
+    int err = errno;
+    ::close(fd);
+    throw std::system_error(err, std::generic_category());
+  }
+
+  // Requests are forwarded one at a time: each one is answered by exactly one
+  // line, but for quit.
+  block_reader requests(STDIN_FILENO);
+  block_reader responses(fd);
+  buffered_writer server(fd);
+  buffered_writer output(STDOUT_FILENO);
+  std::string line;
+  std::vector<std::string_view> args;
+  int ret = 0;
+
+  while (requests.next_line(line))
+  {
+    server.write(line);
+    server.put('\n');
+    server.flush();
+
+    args.clear();
+    split_tokens(line, args);
+
+    if (!args.empty() && args[0] == "quit") break;
+
+    if (!responses.next_line(line))
+    {
+      std::cerr << _("The connection has been closed by the server.\n");
+      ret = 1;
+      break;
+    }
+
+    output.write(line);
+    output.put('\n');
+
+    if (!requests.buffered()) output.flush();
+  }
+
+  output.flush();
+  ::close(fd);
+
+  return ret;
+}
+
+int open_listening_socket()
+{
+  sockaddr_un address = socket_address(socket_path);
+
+  // A socket left behind by a previous instance is replaced; any other file is
+  // left alone and bind() fails.
+  struct stat st;
+  if (::lstat(socket_path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+    ::unlink(socket_path.c_str());
+
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+  if (fd < 0) throw std::system_error(errno, std::generic_category());
+
+  // Only the owner may connect: the socket is created with mode 0600 instead
+  // of being changed after bind(), which would leave a window open to other
+  // users.  No other thread exists yet to be affected by the umask.
+  mode_t mask = ::umask(0177);
+  int ret = ::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+  int err = errno;
+  ::umask(mask);
+
+  if (ret != 0 || ::listen(fd, SOMAXCONN) != 0)
+  {
+    if (ret == 0) err = errno;
+    ::close(fd);
+    throw std::system_error(err, std::generic_category());
+  }
+
+  return fd;
+}
+
+bool load_catalogs(catalog_store& store)
+{
+  for (const auto& entry : preloaded_catalogs)
+  {
+    try
+    {
+      mapped_input input(entry.second);
+      store.put(entry.first, parse_catalog(input.data()));
+    }
+    catch (std::system_error& ex)
+    {
+      std::cerr << entry.second << ": " << ex.what() << "\n";
+      return false;
+    }
+    catch (std::invalid_argument& ex)
+    {
+      std::cerr << entry.second << ": " << ex.what() << "\n";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int run_server()
+{
+  catalog_store store;
+
+  if (!load_catalogs(store)) return 1;
+
+  // Termination signals are handled synchronously by the main thread, which
+  // stops the server; they are blocked before any other thread is created so
+  // that the threads of the pool inherit the mask.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGHUP);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  int listen_fd = open_listening_socket();
+  catalog_server server(store, jobs, catalog_dir, idle_timeout);
+  std::exception_ptr failure;
+
+  std::thread acceptor([&]
+                       {
+                         try
+                         {
+                           server.run(listen_fd);
+                         }
+                         catch (...)
+                         {
+                           failure = std::current_exception();
+                           ::kill(::getpid(), SIGTERM);
+                         }
+                       });
+
+  int sig;
+  sigwait(&signals, &sig);
+
+  server.stop();
+  acceptor.join();
+
+  ::close(listen_fd);
+  ::unlink(socket_path.c_str());
+
+  if (failure) std::rethrow_exception(failure);
+
+  return 0;
+}
+
+void parse_opts(int argc, char **argv)
+{
+  int ch;
+  unsigned long n;
+  std::string short_options = "C:d:hj:t:";
+
+  int option_index = 0;
+  static struct option long_options[] = {
+    {"catalog",      required_argument, nullptr, 'C'},
+    {"catalog-dir",  required_argument, nullptr, 'd'},
+    {"client",       no_argument,       nullptr, OPT_CLIENT},
+    {"help",         no_argument,       nullptr, 'h'},
+    {"idle-timeout", required_argument, nullptr, 't'},
+    {"jobs",         required_argument, nullptr, 'j'},
+    {"version",      no_argument,       nullptr, OPT_VERSION},
+    {nullptr,        0,                 nullptr, 0}
+  };
+
+  while ((ch = getopt_long(argc,
+                           argv,
+                           short_options.c_str(),
+                           long_options,
+                           &option_index)) != -1)
+  {
+    switch (ch)
+    {
+    case 'C':
+    {
+      std::string spec(optarg);
+      size_t eq = spec.find('=');
+
+      if (eq == 0 || eq == std::string::npos || eq + 1 == spec.size())
+      {
+        std::cerr << _("Invalid catalog: ") << spec << "\n";
+        exit(1);
+      }
+
+      preloaded_catalogs.emplace_back(spec.substr(0, eq), spec.substr(eq + 1));
+      break;
+    }
+
+    case 'd':
+      catalog_dir = optarg;
+      break;
+
+    case 'h':
+      usage(std::cout);
+      exit(0);
+
+    case 'j':
+      if (!parse_number(optarg, std::numeric_limits<unsigned int>::max(), n)
+          || n == 0)
+      {
+        std::cerr << _("Invalid number of jobs: ") << optarg << "\n";
+        exit(1);
+      }
+
+      jobs = static_cast<unsigned int>(n);
+      break;
+
+    case 't':
+      if (!parse_number(optarg, std::numeric_limits<unsigned int>::max(), n))
+      {
+        std::cerr << _("Invalid timeout: ") << optarg << "\n";
+        exit(1);
+      }
+
+      idle_timeout = static_cast<unsigned int>(n);
+      break;
+
+    case OPT_CLIENT:
+      client = true;
+      break;
+
+    case OPT_VERSION:
+      print_version();
+      exit(SEMVER_EXIT_OK);
+
+    case '?':
+      exit(1);
+
+    default:
+      usage(std::cerr);
+      exit(2);
+    }
+  }
+
+  if (optind != argc - 1)
+  {
+    std::cerr << _("A socket path must be specified.\n");
+    exit(1);
+  }
+
+  socket_path = argv[optind];
+
+  if (client
+      && (jobs != 0
+          || !preloaded_catalogs.empty()
+          || !catalog_dir.empty()
+          || idle_timeout != DEFAULT_IDLE_TIMEOUT))
+  {
+    std::cerr << _("--client cannot be used with -C, -d, -j or -t.\n");
+    exit(1);
+  }
+
+  if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+}
+
+void print_version()
+{
+  std::cout << "semverd (" << PACKAGE_STRING << ")\n";
+  std::cout <<
+         "Copyright (C) 2016-2024 Enrico M. Crisostomo <enrico.m.crisostomo@gmail.com>.\n";
+  std::cout <<
+         _("License GPLv3+: GNU GPL version 3 or later <http://gnu.org/licenses/gpl.html>.\n");
+  std::cout <<
+         _("This is free software: you are free to change and redistribute it.\n");
+  std::cout << _("There is NO WARRANTY, to the extent permitted by law.\n");
+  std::cout << "\n";
+  std::cout << _("Written by Enrico M. Crisostomo.");
+  std::cout << std::endl;
+}
+
+void usage(std::ostream& stream)
+{
+  stream << PACKAGE_STRING << "\n\n";
+  stream << _("Usage:\n");
+  stream << "semverd" << _(" (option)* socket\n");
+  stream << "\n";
+  stream << _("Options:\n");
+  stream << " -C, --catalog name=file  " << _("Load a catalog at startup.\n");
+  stream << " -d, --catalog-dir dir    " << _("Allow clients to load the catalogs of dir.\n");
+  stream << "     --client             " << _("Send the requests read from the standard input to a server.\n");
+  stream << " -h, --help               " << _("Show this message.\n");
+  stream << " -j, --jobs n             " << _("Serve up to n clients concurrently.\n");
+  stream << " -t, --idle-timeout secs  " << _("Close the connections idle for secs seconds (0: never).\n");
+  stream << "\n";
+  stream << _("See the man page for more information.\n\n");
+  stream << _("Report bugs to <") << PACKAGE_BUGREPORT << ">.\n";
+  stream << _("Project home page: <") << PACKAGE_URL << ">.";
+  stream << "\n";
+}
@@ -0,0 +1,703 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file
+ * @brief Tests of the `libsemver` classes that the `semver` program does not
+ * expose.
+ *
+ * The test to run is named by the only argument, so that each one is a
+ * separate CTest test.  A failed check is reported with its line, and the
+ * test exits with a non-zero status.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "libsemver/c++/basic_version.hpp"
+#include "libsemver/c++/catalog.hpp"
+#include "libsemver/c++/columnar_set.hpp"
+#include "libsemver/c++/concurrent_catalog.hpp"
+#include "libsemver/c++/intern_pool.hpp"
+#include "libsemver/c++/version.hpp"
+#include "libsemver/c++/version_batch.hpp"
+#include "libsemver/c++/version_literal.hpp"
+#include "libsemver/c++/version_reader.hpp"
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+static int failures = 0;
+
+static void check(bool condition, const char *expression, int line)
+{
+  if (condition) return;
+
+  std::cerr << __FILE__ << ":" << line << ": check failed: " << expression
+            << "\n";
+  ++failures;
+}
+
+template <typename E, typename F>
+static bool throws(F f)
+{
+  try
+  {
+    f();
+  }
+  catch (E& ex)
+  {
+    return true;
+  }
+
+  return false;
+}
+
+template <typename F>
+static bool throws_invalid_argument(F f)
+{
+  return throws<std::invalid_argument>(f);
+}
+
+static int sign(int n)
+{
+  return (n > 0) - (n < 0);
+}
+
+static void test_basic_version()
+{
+  CHECK(std::is_trivially_copyable<semver::version3>::value);
+  CHECK(semver::version3({1, 2, 3}) < semver::version3({1, 10, 0}));
+  CHECK(semver::version3({1, 2, 3}) == semver::version3({1, 2, 3}));
+
+  semver::version3 v =
+    semver::version3::from_version(semver::version::from_string("1.20.3"));
+  CHECK(v[0] == 1 && v[1] == 20 && v[2] == 3);
+  CHECK(v.to_version().str() == "1.20.3");
+
+  // The order is the order of semver::version, component by component.
+  const std::vector<std::string> releases = {
+    "0.0.0", "0.0.1", "0.1.0", "0.10.0", "1.0.0", "1.0.10", "1.2.3", "1.10.0",
+    "2.0.0", "4294967295.0.0", "4294967295.4294967295.4294967295"
+  };
+
+  for (const auto& l : releases)
+  {
+    semver::version lv = semver::version::from_string(l);
+    semver::version3 lb = semver::version3::from_version(lv);
+
+    for (const auto& r : releases)
+    {
+      semver::version rv = semver::version::from_string(r);
+      semver::version3 rb = semver::version3::from_version(rv);
+      int expected = lv < rv ? -1 : (rv < lv);
+
+      CHECK(semver::version3::compare(lb, rb) == expected);
+      CHECK((lb < rb) == (expected < 0));
+      CHECK((lb >= rb) == (expected >= 0));
+      CHECK((lb == rb) == (expected == 0));
+    }
+  }
+
+  using version4 = semver::basic_version<4, uint64_t>;
+  semver::version v4(
+    std::vector<std::string>{"1", "2", "3", "18446744073709551615"});
+  CHECK(version4::from_version(v4)[3] == UINT64_MAX);
+  CHECK(version4::from_version(v4).to_version().str() == v4.str());
+  CHECK(version4({1, 2, 3, 4}) > version4({1, 2, 3, 3}));
+
+  using version16 = semver::basic_version<3, uint16_t>;
+  CHECK(version16::from_version(
+    semver::version::from_string("65535.0.0"))[0] == 65535);
+  CHECK(throws<std::out_of_range>(
+    []
+    {
+      version16::from_version(semver::version::from_string("65536.0.0"));
+    }));
+  CHECK(throws<std::out_of_range>(
+    []
+    {
+      semver::version3::from_version(
+        semver::version::from_string("4294967296.0.0"));
+    }));
+  CHECK(throws_invalid_argument(
+    []
+    {
+      semver::version3::from_version(
+        semver::version::from_string("1.0.0-rc.1"));
+    }));
+  CHECK(throws_invalid_argument(
+    [&v4]
+    {
+      semver::version3::from_version(v4);
+    }));
+}
+
+static void test_intern_pool()
+{
+  semver::intern_pool pool;
+  CHECK(pool.empty());
+
+  // Equal strings are interned once, into a copy owned by the pool.
+  std::string alpha = "alpha";
+  std::string_view a1 = pool.intern(alpha);
+  alpha = "ALPHA";
+  std::string_view a2 = pool.intern(std::string("alpha"));
+  std::string_view b = pool.intern("beta.1");
+
+  CHECK(a1 == "alpha");
+  CHECK(a1.data() == a2.data());
+  CHECK(b == "beta.1");
+  CHECK(b.data() != a1.data());
+  CHECK(pool.intern("").empty());
+  CHECK(pool.size() == 3);
+
+  // The views stay valid while strings are added to the pool.
+  for (unsigned i = 0; i < 10000; ++i) pool.intern("s" + std::to_string(i));
+
+  CHECK(a1 == "alpha" && pool.intern("alpha").data() == a1.data());
+  CHECK(pool.size() == 10003);
+
+  // The versions parsed with a pool share its strings.
+  semver::version v1 = semver::version::from_string("1.0.0-beta.1+b7", pool);
+  semver::version v2 = semver::version::from_string("2.0.0-beta.1+b7", pool);
+  CHECK(v1.get_prerelease_view().data() == b.data());
+  CHECK(v2.get_prerelease_view().data() == b.data());
+  CHECK(v1.get_metadata_view().data() == v2.get_metadata_view().data());
+  CHECK(v1 < v2);
+  CHECK(v2.str() == "2.0.0-beta.1+b7");
+  CHECK(pool.size() == 10004);
+
+  // Moves keep sharing the strings, copies own them unless they are
+  // constructed with a pool.
+  semver::version moved = std::move(v2);
+  semver::version copied = v1;
+  semver::version assigned = semver::version::from_string("3.0.0");
+  assigned = v1;
+  semver::version shared(v1, pool);
+  CHECK(moved.get_prerelease_view().data() == b.data());
+  CHECK(copied.get_prerelease_view().data() != b.data());
+  CHECK(assigned.get_metadata_view().data() != v1.get_metadata_view().data());
+  CHECK(shared.get_prerelease_view().data() == b.data());
+  CHECK(copied == v1 && assigned == v1 && shared == v1);
+
+  CHECK(throws_invalid_argument(
+    [&pool]
+    {
+      semver::version::from_string("1.0.0-", pool);
+    }));
+
+  pool.clear();
+  CHECK(pool.empty());
+  CHECK(copied.str() == "1.0.0-beta.1+b7");
+  CHECK(assigned.str() == "1.0.0-beta.1+b7");
+  CHECK(copied < semver::version::from_string("2.0.0"));
+  CHECK(pool.intern("alpha") == "alpha");
+  CHECK(pool.size() == 1);
+}
+
+static void test_catalog()
+{
+  semver::catalog catalog;
+
+  for (const char *s : {"1.0.0", "1.4.0", "1.5.0-rc.1", "2.0.0-rc.1", "2.0.0",
+                        "2.1.0-beta", "3.0.0-alpha"})
+    catalog.insert(semver::version::from_string(s));
+
+  // Versions with two or four components belong to their major line too.
+  catalog.insert(semver::version(std::vector<std::string>{"2", "0"}));
+  catalog.insert(semver::version(std::vector<std::string>{"1", "4", "0", "1"}));
+  catalog.insert(semver::version(std::vector<std::string>{"4", "0"}, "rc.1"));
+
+  CHECK(catalog.latest_release(1)->str() == "1.4.0.1");
+  CHECK(catalog.latest_release(2)->str() == "2.0.0");
+  CHECK(!catalog.latest_release(3));
+  CHECK(!catalog.latest_release(4));
+  CHECK(!catalog.latest_release(0));
+
+  catalog.erase(semver::version::from_string("2.0.0"));
+  catalog.erase(semver::version::from_string("1.0.0"));
+  CHECK(catalog.latest_release(2)->str() == "2.0");
+  CHECK(catalog.latest_release(1)->str() == "1.4.0.1");
+
+  // Copies index their own releases, and the prereleases published after the
+  // latest release do not hide it.
+  semver::catalog copy(catalog);
+  catalog.clear();
+  CHECK(!catalog.latest_release(1));
+
+  for (int i = 0; i < 1000; ++i)
+    copy.insert(semver::version::from_string("1.9.0-rc." + std::to_string(i)));
+
+  CHECK(copy.latest_release(1)->str() == "1.4.0.1");
+  CHECK(copy.latest_release(2)->str() == "2.0");
+
+  catalog = copy;
+  copy.erase(semver::version(std::vector<std::string>{"2", "0"}));
+  CHECK(!copy.latest_release(2));
+  CHECK(catalog.latest_release(2)->str() == "2.0");
+}
+
+static void test_concurrent_catalog()
+{
+  // More catalogs than a thread caches the snapshots of.
+  static const size_t CATALOGS = 10;
+  semver::concurrent_catalog catalogs[CATALOGS];
+  std::atomic<bool> writing(true);
+  std::atomic<unsigned> regressions(0);
+
+  // Readers see the snapshots of each catalog grow, whatever the catalogs
+  // sharing their cache slots.
+  std::vector<std::thread> readers;
+  for (unsigned r = 0; r < 4; ++r)
+    readers.emplace_back(
+      [&]
+      {
+        size_t last[CATALOGS] = {};
+
+        while (writing.load())
+          for (size_t i = 0; i < CATALOGS; ++i)
+          {
+            size_t size = catalogs[i].get()->size();
+            if (size < last[i]) ++regressions;
+            last[i] = size;
+          }
+      });
+
+  std::vector<std::thread> writers;
+  for (unsigned w = 0; w < 4; ++w)
+    writers.emplace_back(
+      [&catalogs, w]
+      {
+        for (unsigned n = 0; n < 200; ++n)
+          for (auto& c : catalogs)
+            c.insert({semver::version::from_string(
+              std::to_string(w) + "." + std::to_string(n) + ".0")});
+      });
+
+  for (auto& t : writers) t.join();
+  writing = false;
+  for (auto& t : readers) t.join();
+
+  CHECK(regressions == 0);
+
+  for (auto& c : catalogs)
+  {
+    CHECK(c.get()->size() == 800);
+    CHECK(c.get() == c.get());
+    CHECK(c.erase({semver::version::from_string("0.0.0"),
+                   semver::version::from_string("9.9.9")}) == 1);
+    CHECK(c.get()->size() == 799);
+  }
+}
+
+// Orders versions as a semver::columnar_set does: by precedence, then by
+// metadata.
+static bool columnar_order(const semver::version& lh, const semver::version& rh)
+{
+  if (lh < rh) return true;
+  if (rh < lh) return false;
+
+  return lh.get_metadata_view() < rh.get_metadata_view();
+}
+
+static void test_columnar_set()
+{
+  // Values spanning several blocks, with runs of equal values and values
+  // needing all 64 bits.
+  std::vector<uint64_t> values;
+  for (uint64_t i = 0; i < 3 * semver::packed_column::BLOCK_SIZE + 7; ++i)
+    values.push_back((i % 5 == 0) ? UINT64_MAX - i : (i / 50) * 1000);
+
+  semver::packed_column column(values);
+  CHECK(column.size() == values.size());
+
+  for (size_t i = 0; i < values.size(); ++i) CHECK(column[i] == values[i]);
+
+  const std::vector<std::string> strings = {
+    "1.0.0", "0.9.12", "1.0.0-rc.1", "1.0.0-alpha", "1.0.0-alpha.1",
+    "1.0.0-beta.11", "1.0.0-beta.2", "1.0.0+build.2", "1.0.0+build.1",
+    "1.0.0-rc.1+b", "18446744073709551615.0.0", "4294967296.1.2", "2.0.0",
+    "1.0.0", "1.0.0-rc.1", "1.0.0+build.1"
+  };
+
+  std::vector<semver::version> expected;
+  semver::columnar_set::builder builder;
+
+  for (const auto& s : strings)
+  {
+    expected.push_back(semver::version::from_string(s));
+    builder.add(expected.back());
+  }
+
+  // A version with more components sorts after its prefix.
+  expected.emplace_back(std::vector<std::string>{"2", "0", "0", "1"});
+  builder.add(expected.back());
+
+  // A component overflowing 64 bits is rejected and leaves the builder as it
+  // was.
+  CHECK([&builder]
+        {
+          try
+          {
+            builder.add(
+              semver::version::from_string("18446744073709551616.0.0"));
+          }
+          catch (std::out_of_range& ex)
+          {
+            return true;
+          }
+
+          return false;
+        }());
+
+  std::sort(expected.begin(), expected.end(), columnar_order);
+  expected.erase(std::unique(expected.begin(),
+                             expected.end(),
+                             [](const semver::version& lh,
+                                const semver::version& rh)
+                             {
+                               return lh.str() == rh.str();
+                             }),
+                 expected.end());
+
+  semver::columnar_set set = builder.build();
+  CHECK(set.size() == expected.size());
+  CHECK(set.size() == 14);
+
+  size_t row = 0;
+
+  for (const semver::version& v : set)
+  {
+    CHECK(row < expected.size() && v.str() == expected[row].str());
+    ++row;
+  }
+
+  CHECK(row == set.size());
+
+  for (size_t i = 0; i < set.size() && i < expected.size(); ++i)
+  {
+    CHECK(set[i].str() == expected[i].str());
+    CHECK(set.arity(i) == expected[i].get_version_count());
+    CHECK(set.prerelease(i) == expected[i].get_prerelease_view());
+    CHECK(set.metadata(i) == expected[i].get_metadata_view());
+  }
+
+  CHECK(set.component(set.size() - 1, 0) == UINT64_MAX);
+
+  // The builder is left empty.
+  CHECK(builder.build().empty());
+}
+
+static void test_prerelease_component()
+{
+  // Standalone components own their identifier and compare as the
+  // identifiers of a prerelease do.
+  const std::vector<std::string> ids = {
+    "0", "1", "2", "11", "99999999999999999999", "100000000000000000000",
+    "-", "a", "alpha", "alpha-1", "beta", "rc"
+  };
+
+  for (size_t i = 0; i < ids.size(); ++i)
+  {
+    semver::prerelease_component l(ids[i]);
+
+    for (size_t j = 0; j < ids.size(); ++j)
+    {
+      semver::prerelease_component r(ids[j]);
+
+      CHECK((l < r) == (i < j));
+      CHECK((l > r) == (i > j));
+      CHECK((l == r) == (i == j));
+    }
+  }
+
+  // The tokens of a version do not own their identifier.
+  CHECK(sizeof(semver::prerelease_token) <= 3 * sizeof(uint64_t));
+}
+
+static void test_version_literal()
+{
+  using namespace semver::literals;
+
+  constexpr semver::version_literal v = "1.2.3-rc.1+build.5"_semver;
+  CHECK(v.size() == 3);
+  CHECK(v.component(0) == "1");
+  CHECK(v.component(1) == "2");
+  CHECK(v.component(2) == "3");
+  CHECK(v.component(3) == "0");
+  CHECK(v.prerelease() == "rc.1");
+  CHECK(v.metadata() == "build.5");
+  CHECK(!v.is_release());
+  CHECK("1.0.0"_semver.is_release());
+
+  // Numeric components have any length, as with from_string().
+  constexpr semver::version_literal big = "1.3.1234567890123456789012"_semver;
+  CHECK(big.component(2) == "1234567890123456789012");
+  CHECK(big == semver::version::from_string("1.3.1234567890123456789012"));
+  CHECK(big.to_version().str() == "1.3.1234567890123456789012");
+
+  // Versions built with more components are greater than their prefix.
+  CHECK(semver::version(std::vector<std::string>{"1", "2", "3", "0"})
+        > "1.2.3"_semver);
+
+  // Components compare as numbers, whatever their length.
+  CHECK(semver::version::from_string("1.9.0")
+        < semver::version::from_string("1.10.0"));
+  CHECK(semver::version::from_string("99999999999999999999.0.0")
+        < semver::version::from_string("100000000000000000000.0.0"));
+  CHECK(!(semver::version(std::vector<std::string>{"1", "02", "3"})
+          < semver::version::from_string("1.2.3")));
+
+  for (const char *s : {"1.2", "1.2.3.4", "18446744073709551615.0.0.1",
+                        "01.2.3", "1.2.3-01", "1.2.3-", "1.2.3+", "1.2.3-a..b",
+                        "1.2.3-a_b", "v1.2.3", "1.2.3 "})
+    CHECK(throws_invalid_argument([s] { semver::version_literal l(s); }));
+
+  // A literal compares with a version as the version it represents.
+  const std::vector<std::string> versions = {
+    "0.0.1", "1.0.0-alpha", "1.0.0-alpha.1", "1.0.0-alpha.beta", "1.0.0-beta",
+    "1.0.0-beta.2", "1.0.0-beta.11", "1.0.0-rc.1", "1.0.0", "1.0.0+build",
+    "1.2.3", "1.10.0", "2.0.0", "99999999999999999999.0.0"
+  };
+
+  for (const auto& l : versions)
+  {
+    semver::version lv = semver::version::from_string(l);
+
+    for (const auto& r : versions)
+    {
+      semver::version_literal rl(r);
+      semver::version rv = semver::version::from_string(r).strip_metadata();
+      int expected = lv.strip_metadata() < rv ? -1 : (rv < lv.strip_metadata());
+
+      CHECK(sign(semver::compare(lv, rl)) == expected);
+      CHECK((lv < rl) == (expected < 0));
+      CHECK((rl < lv) == (expected > 0));
+      CHECK((lv == rl) == (expected == 0));
+    }
+  }
+}
+
+static void test_version_batch()
+{
+  // More versions than a mask word holds, so that the columns are compared
+  // across several words and a partial last one.
+  std::vector<semver::version> versions;
+  for (unsigned i = 0; i < 150; ++i)
+    versions.push_back(semver::version::from_string(
+      std::to_string(i % 3) + "." + std::to_string(i % 7) + "."
+      + std::to_string(i % 11)));
+
+  for (const char *s : {"1.2.3-alpha", "1.2.3-rc.1", "1.2.3", "1.2.3+build.1",
+                        "1.2.4-0", "18446744073709551615.0.0",
+                        "18446744073709551616.0.0", "0.0.0"})
+    versions.push_back(semver::version::from_string(s));
+
+  // Versions that the columns do not represent are compared one by one.
+  versions.emplace_back(std::vector<std::string>{"1", "2"});
+  versions.emplace_back(std::vector<std::string>{"1", "2", "3", "0"});
+
+  semver::version_batch batch;
+  CHECK(batch.empty());
+
+  for (const auto& v : versions) batch.push_back(v);
+
+  CHECK(batch.size() == versions.size());
+
+  for (size_t i = 0; i < versions.size(); ++i)
+    CHECK(batch[i].str() == versions[i].str());
+
+  for (const char *s : {"0.0.0", "1.2.3-alpha", "1.2.3-beta", "1.2.3",
+                        "1.2.3+other", "1.2.4-0", "1.2.10", "2.6.10",
+                        "18446744073709551615.0.0", "99999999999999999999.0.0"})
+  {
+    semver::version v = semver::version::from_string(s);
+    std::vector<size_t> expected;
+
+    for (size_t i = 0; i < versions.size(); ++i)
+      if (v < versions[i]) expected.push_back(i);
+
+    CHECK(batch.greater_than(v) == expected);
+
+    std::vector<uint64_t> mask = batch.greater_mask(v);
+    CHECK(mask.size() == (versions.size() + 63) / 64);
+
+    for (size_t i = 0; i < versions.size() && i / 64 < mask.size(); ++i)
+      CHECK(((mask[i / 64] >> (i % 64)) & 1)
+            == static_cast<uint64_t>(v < versions[i]));
+  }
+}
+
+// Stream buffer returning one piece of its input per underflow, like a socket
+// receiving the input in separate packets.
+class piecewise_buf : public std::streambuf
+{
+public:
+  explicit piecewise_buf(std::vector<std::string> pieces) :
+    pieces(std::move(pieces))
+  {
+  }
+
+  size_t underflows = 0;
+
+protected:
+  int_type underflow() override
+  {
+    if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+    if (underflows == pieces.size()) return traits_type::eof();
+
+    std::string& piece = pieces[underflows++];
+    setg(piece.data(), piece.data(), piece.data() + piece.size());
+
+    return traits_type::to_int_type(*gptr());
+  }
+
+private:
+  std::vector<std::string> pieces;
+};
+
+// Reads all the tokens of @p reader, marking the invalid ones with `!`.
+static std::vector<std::string> read_tokens(semver::version_reader& reader)
+{
+  std::vector<std::string> tokens;
+  semver::parsed_version parsed;
+
+  while (reader.next(parsed))
+  {
+    CHECK(parsed.ok() == parsed.error.empty());
+    CHECK(!parsed.ok() || parsed.value->str() == parsed.token);
+    tokens.push_back(parsed.ok() ? parsed.token : "!" + parsed.token);
+  }
+
+  return tokens;
+}
+
+static void test_version_reader()
+{
+  const std::string input =
+    "  1.2.3\t1.0.0-alpha.1+build.5\n\n01.2.3 10.20.30-rc.1 x\r\n"
+    "1.2.3-0123 1.2.3";
+  const std::vector<std::string> expected = {
+    "1.2.3", "1.0.0-alpha.1+build.5", "!01.2.3", "10.20.30-rc.1", "!x",
+    "!1.2.3-0123", "1.2.3"
+  };
+
+  // Small chunks split most tokens, and the separators, across chunks.
+  for (size_t chunk_size : {1, 2, 3, 5, 7, 16, 4096})
+  {
+    std::istringstream in(input);
+    semver::version_reader reader(in, chunk_size);
+    CHECK(read_tokens(reader) == expected);
+
+    // A reader function may return fewer bytes than asked.
+    size_t offset = 0;
+    semver::version_reader partial(
+      [&input, &offset](char *buf, size_t size)
+      {
+        size_t n = std::min({size, input.size() - offset, size_t(2)});
+        input.copy(buf, n, offset);
+        offset += n;
+        return n;
+      },
+      chunk_size);
+    CHECK(read_tokens(partial) == expected);
+  }
+
+  // A token longer than many chunks.
+  std::string big = "1.2." + std::string(1000, '9');
+  std::istringstream big_in(" " + big + " ");
+  semver::version_reader big_reader(big_in, 3);
+  CHECK(read_tokens(big_reader) == std::vector<std::string>{big});
+
+  // A token is yielded as soon as it has arrived, without waiting for the
+  // following pieces of the input.
+  piecewise_buf pieces({"1.2.3 1.", "0.0 ", "2.0.0"});
+  std::istream pieces_in(&pieces);
+  semver::version_reader pieces_reader(pieces_in);
+  semver::parsed_version parsed;
+  CHECK(pieces_reader.next(parsed) && parsed.token == "1.2.3");
+  CHECK(pieces.underflows == 1);
+  CHECK(pieces_reader.next(parsed) && parsed.token == "1.0.0");
+  CHECK(pieces.underflows == 2);
+  CHECK(read_tokens(pieces_reader) == std::vector<std::string>{"2.0.0"});
+  CHECK(pieces_in.eof());
+
+  std::istringstream empty("  \n\t ");
+  semver::version_reader empty_reader(empty, 2);
+  CHECK(read_tokens(empty_reader).empty());
+
+  // The iterator yields the same tokens.
+  std::istringstream it_in(input);
+  semver::version_reader it_reader(it_in, 4);
+  std::vector<std::string> tokens;
+  for (const semver::parsed_version& p : it_reader)
+    tokens.push_back(p.ok() ? p.token : "!" + p.token);
+  CHECK(tokens == expected);
+
+  int fds[2];
+  CHECK(pipe(fds) == 0);
+  CHECK(write(fds[1], input.data(), input.size())
+        == static_cast<ssize_t>(input.size()));
+  close(fds[1]);
+  semver::version_reader fd_reader(fds[0], 3);
+  CHECK(read_tokens(fd_reader) == expected);
+  close(fds[0]);
+
+  semver::version_reader bad_fd_reader(-1);
+  CHECK(throws<std::system_error>(
+    [&bad_fd_reader]
+    {
+      read_tokens(bad_fd_reader);
+    }));
+}
+
+int main(int argc, char **argv)
+{
+  static const std::map<std::string, void (*)()> tests = {
+    {"basic_version", test_basic_version},
+    {"catalog", test_catalog},
+    {"columnar_set", test_columnar_set},
+    {"concurrent_catalog", test_concurrent_catalog},
+    {"intern_pool", test_intern_pool},
+    {"prerelease_component", test_prerelease_component},
+    {"version_batch", test_version_batch},
+    {"version_literal", test_version_literal},
+    {"version_reader", test_version_reader}
+  };
+
+  auto test = (argc == 2) ? tests.find(argv[1]) : tests.end();
+
+  if (test == tests.end())
+  {
+    std::cerr << "Usage: libsemver_test test\n";
+    return 2;
+  }
+
+  test->second();
+
+  return failures == 0 ? 0 : 1;
+}
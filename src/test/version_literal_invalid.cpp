@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2016-2024 Enrico M. Crisostomo
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @brief Compile-time check of the `_semver` literal.
+ *
+ * This file is compiled by CMake when the project is configured, and it must
+ * not compile: a `constexpr` version literal that does not comply with
+ * _Semantic Versioning 2.0.0_ is a compile error.  Defined as
+ * `SEMVER_VALID_LITERAL`, it must compile, which makes sure that the failure
+ * comes from the literal.
+ */
+#include "libsemver/c++/version_literal.hpp"
+
+using namespace semver::literals;
+
+#ifdef SEMVER_VALID_LITERAL
+constexpr auto v = "1.2.0"_semver;
+#else
+constexpr auto v = "1.2"_semver;
+#endif
+
+static_assert(v.size() == 3);